@@ -1,9 +1,32 @@
 #!/bin/bash
 
 # Please use autoformat and change the newlines according to https://github.com/openrazer/openrazer/blob/master/pylib/openrazer/client/devices/__init__.py#L44
+#
+# Usage: ./capabilities_to_cpp.sh [setup|enum|names]
+#   setup: the body of Device::setupCapabilities() (default)
+#   enum:  the entries of the Capability enum in libopenrazer.h
+#   names: the entries of the capabilityNames table in libopenrazer.cpp
+
+mode=${1:-setup}
 
 pyfile=$(curl -s https://raw.githubusercontent.com/openrazer/openrazer/master/pylib/openrazer/client/devices/__init__.py)
 incapabilities=false
+
+# Prints the line for the capability $1, using $2 as the check in setup mode
+output() {
+    case $mode in
+        enum)
+            echo "    CAP_${1^^},"
+            ;;
+        names)
+            echo "    \"$1\","
+            ;;
+        *)
+            echo "capabilities.set(CAP_${1^^}, $2);"
+            ;;
+    esac
+}
+
 while read -r line; do
     if [ $incapabilities = false ]; then
         # Check if in startline
@@ -13,6 +36,9 @@ while read -r line; do
     else
         # Exit when method is finished
         if [[ $line == *"}"* ]]; then
+            if [ $mode = enum ]; then
+                echo "    CAP_COUNT"
+            fi
             exit 0
         fi
 # for debugging
@@ -24,20 +50,24 @@ while read -r line; do
             interface=$(echo $line | cut -d "'" -f 4)
             method=$(echo $line | cut -d "'" -f 6)
             if [ -z "$method" ]; then
-                echo 'capabilities.insert("'$variable'", hasCapabilityInternal("'$interface'"));'
+                output "$variable" 'hasCapabilityInternal("'$interface'")'
             else
-                echo 'capabilities.insert("'$variable'", hasCapabilityInternal("'$interface'", "'$method'"));'
+                output "$variable" 'hasCapabilityInternal("'$interface'", "'$method'")'
             fi
         elif [[ $line == *"#"* ]]; then
-            echo $line | sed 's/#/\/\//' | sed -e 's/^[[:space:]]*//'
+            if [ $mode = setup ]; then
+                echo $line | sed 's/#/\/\//' | sed -e 's/^[[:space:]]*//'
+            fi
         elif [[ $line == *": True"* ]]; then
             variable=$(echo $line | cut -d "'" -f 2)
-            echo 'capabilities.insert("'$variable'", true);'
+            output "$variable" 'true'
         elif [[ $line == "" ]]; then
-            echo
+            if [ $mode = setup ]; then
+                echo
+            fi
         else # unknown and special cases
             if [[ $line == *"lighting_led_matrix"* ]]; then # a different format is used here
-                echo 'capabilities.insert("lighting_led_matrix", hasMatrix());'
+                output "lighting_led_matrix" 'hasMatrix()'
             else
                 # About the xargs: lol http://stackoverflow.com/a/12973694/3527128
                 echo "// FIXME: "$line | xargs
@@ -45,4 +75,3 @@ while read -r line; do
         fi
     fi
 done <<< "$pyfile"
-
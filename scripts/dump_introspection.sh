@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Dumps the introspection XML of all devices connected to the running daemon, one file per device.
+# Merge new interfaces and methods into src/libopenrazer/dbus/razer.device.xml, razerproxygen generates the code from it
+# (it also accepts several files and merges their interfaces).
+#
+# Usage: ./dump_introspection.sh [outputdir]
+
+outdir=${1:-.}
+
+serials=$(gdbus call --session --dest org.razer --object-path /org/razer --method razer.devices.getDevices | grep -o "'[^']*'" | tr -d "'")
+
+for serial in $serials; do
+    gdbus introspect --session --dest org.razer --object-path /org/razer/device/$serial --xml > $outdir/$serial.xml
+    echo "Wrote $outdir/$serial.xml"
+done
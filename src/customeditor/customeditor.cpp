@@ -92,6 +92,9 @@ CustomEditor::CustomEditor(libopenrazer::Device* device, bool launchMatrixDiscov
         closeWindow();
     }
 
+    // The lighting could have been changed since the last frame was sent
+    device->invalidateMatrixFrame();
+
     // Set every LED to "off"/black
     clearAll();
 }
@@ -286,37 +289,28 @@ bool CustomEditor::parseKeyboardJSON(QString jsonname)
     return true;
 }
 
-bool CustomEditor::updateKeyrow(int row)
+bool CustomEditor::updateMatrix()
 {
-    return device->setKeyRow(row, 0, dimens[1]-1, colors[row]) && device->setCustom();
+    // Only the changed rows get sent
+    return device->setMatrixFrame(colors);
 }
 
 void CustomEditor::clearAll()
 {
-    QVector<QColor> blankColors;
-    // Initialize the array with the width of the matrix with black = off
-    for(int i=0; i<dimens[1]; i++) {
-        blankColors << QColor(Qt::black);
-    }
-
-    // Send one request per row
-    for(int i=0; i<dimens[0]; i++) {
-        device->setKeyRow(i, 0, dimens[1]-1, blankColors);
+    // Reset model with black = off
+    for(int i=0; i<colors.size(); i++) {
+        for(int j=0; j<colors[i].size(); j++) {
+            colors[i][j] = QColor(Qt::black);
+        }
     }
 
-    device->setCustom();
+    // Send the whole frame in one request
+    device->setMatrixFrame(colors);
 
     // Reset view
     for(int i=0; i<matrixPushButtons.size(); i++) {
         matrixPushButtons.at(i)->resetButtonColor();
     }
-
-    // Reset model
-    for(int i=0; i<colors.size(); i++) {
-        for(int j=0; j<colors[i].size(); j++) {
-            colors[i][j] = QColor(Qt::black);
-        }
-    }
 }
 
 void CustomEditor::colorButtonClicked()
@@ -361,7 +355,7 @@ void CustomEditor::onMatrixPushButtonClicked()
         qDebug() << "RazerGenie: Unhandled DrawStatus: " << drawStatus;
     }
     // Set color on device
-    updateKeyrow(pos.first);
+    updateMatrix();
 }
 
 void CustomEditor::setDrawStatusSet()
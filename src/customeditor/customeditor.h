@@ -43,7 +43,7 @@ private:
     QLayout* generateMatrixDiscovery();
 
     bool parseKeyboardJSON(QString jsonname);
-    bool updateKeyrow(int row);
+    bool updateMatrix();
     void clearAll();
 
     QJsonObject keyboardKeys;
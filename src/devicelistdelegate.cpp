@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QApplication>
+#include <QPainter>
+#include <QPixmap>
+
+#include "devicelistdelegate.h"
+#include "devicelistmodel.h"
+
+// Height of an entry and of the image area at its top
+#define ENTRY_HEIGHT 120
+#define IMAGE_HEIGHT 75
+#define MARGIN 2
+
+/*
+ * Paints the entries of the device list: the image (or the text shown instead of it) with the device name below, both centered.
+ * Only the cached pixmap is drawn, so painting doesn't create widgets or load files.
+ */
+DeviceListDelegate::DeviceListDelegate(QObject *parent) : QStyledItemDelegate(parent)
+{
+}
+
+DeviceListDelegate::~DeviceListDelegate()
+{
+}
+
+void DeviceListDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    // Background and selection from the style, without the default text and icon
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    QStyle *style = opt.widget != NULL ? opt.widget->style() : QApplication::style();
+    style->drawPrimitive(QStyle::PE_PanelItemViewItem, &opt, painter, opt.widget);
+
+    QRect rect = opt.rect.adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN);
+    QRect imageRect(rect.left(), rect.top(), rect.width(), IMAGE_HEIGHT);
+    QRect nameRect(rect.left(), imageRect.bottom() + MARGIN, rect.width(), rect.bottom() - imageRect.bottom() - MARGIN);
+
+    painter->save();
+    if(opt.state & QStyle::State_Selected) {
+        painter->setPen(opt.palette.color(QPalette::HighlightedText));
+    } else {
+        painter->setPen(opt.palette.color(QPalette::Text));
+    }
+
+    QPixmap image = index.data(Qt::DecorationRole).value<QPixmap>();
+    if(!image.isNull()) {
+        QSize size = image.size() / image.devicePixelRatio();
+        QPoint topLeft(imageRect.left() + (imageRect.width() - size.width())/2, imageRect.top() + (imageRect.height() - size.height())/2);
+        painter->drawPixmap(topLeft, image);
+    } else {
+        painter->drawText(imageRect, Qt::AlignCenter | Qt::TextWordWrap, index.data(DeviceListModel::ImageTextRole).toString());
+    }
+    painter->drawText(nameRect, Qt::AlignHCenter | Qt::AlignTop | Qt::TextWordWrap, index.data(Qt::DisplayRole).toString());
+    painter->restore();
+}
+
+QSize DeviceListDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex & /* index */) const
+{
+    return QSize(option.rect.width(), ENTRY_HEIGHT);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2017-2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -16,27 +16,19 @@
  *
  */
 
-#ifndef DEVICELISTWIDGET_H
-#define DEVICELISTWIDGET_H
+#ifndef DEVICELISTDELEGATE_H
+#define DEVICELISTDELEGATE_H
 
-#include <libopenrazer.h>
-#include <QWidget>
-#include <QLabel>
+#include <QStyledItemDelegate>
 
-class DeviceListWidget : public QWidget
+class DeviceListDelegate : public QStyledItemDelegate
 {
-    Q_OBJECT
 public:
-    DeviceListWidget(QWidget *parent, libopenrazer::Device *device);
-    libopenrazer::Device *device();
-    void setNoImage();
-public slots:
-    void imageDownloaded(QString &filename);
-    void imageDownloadErrored(QString reason, QString longReason);
-private:
-    QPixmap createPixmapFromFile(QString &filename);
-    libopenrazer::Device *mDevice;
-    QLabel *imageLabel;
+    DeviceListDelegate(QObject *parent = 0);
+    ~DeviceListDelegate();
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 };
 
-#endif // DEVICELISTWIDGET_H
+#endif // DEVICELISTDELEGATE_H
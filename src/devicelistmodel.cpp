@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QFile>
+
+#include "devicelistmodel.h"
+#include "razerimagedownloader.h"
+#include "thumbnailcache.h"
+
+/*
+ * Model of the device list, one row per device with its name (Qt::DisplayRole) and image (Qt::DecorationRole).
+ * Adding and removing devices only inserts or removes their rows, so the view doesn't rebuild the whole list on hotplug.
+ */
+DeviceListModel::DeviceListModel(QObject *parent) : QAbstractListModel(parent)
+{
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailReady, this, &DeviceListModel::thumbnailReady);
+}
+
+DeviceListModel::~DeviceListModel()
+{
+}
+
+int DeviceListModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid()) {
+        return 0;
+    }
+    return entries.size();
+}
+
+QVariant DeviceListModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+    const Entry &entry = entries[index.row()];
+    switch(role) {
+    case Qt::DisplayRole:
+        return entry.name;
+    case Qt::DecorationRole:
+        return entry.image;
+    case ImageTextRole:
+        return entry.imageText;
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * Appends \a device to the list, showing its image if it was downloaded before.
+ * The thumbnail is loaded in the background unless it's in memory already.
+ */
+void DeviceListModel::addDevice(libopenrazer::Device *device)
+{
+    Entry entry;
+    entry.device = device;
+    entry.serial = device->serial();
+    entry.name = device->getDeviceName();
+    if(device->getPngFilename().isEmpty()) {
+        entry.imageText = tr("No image");
+    } else {
+        entry.imageUrl = QUrl(device->getPngUrl());
+        QString path = RazerImageDownloader::getFilePath(entry.imageUrl);
+        if(QFile(path).exists()) {
+            entry.image = ThumbnailCache::instance()->thumbnail(path);
+            if(entry.image.isNull()) {
+                ThumbnailCache::instance()->request(path);
+            }
+        } else {
+            entry.imageText = tr("Downloading image...");
+        }
+    }
+
+    beginInsertRows(QModelIndex(), entries.size(), entries.size());
+    entries.append(entry);
+    endInsertRows();
+}
+
+/**
+ * Removes the device in \a row from the list.
+ */
+void DeviceListModel::removeDevice(int row)
+{
+    if(row < 0 || row >= entries.size()) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    entries.removeAt(row);
+    endRemoveRows();
+}
+
+/**
+ * Removes all devices from the list.
+ */
+void DeviceListModel::clear()
+{
+    beginResetModel();
+    entries.clear();
+    endResetModel();
+}
+
+/**
+ * Returns the row of the device with the given \a serial, or -1 if it's not in the list.
+ */
+int DeviceListModel::indexOf(const QString &serial) const
+{
+    for(int i=0; i<entries.size(); i++) {
+        if(entries[i].serial == serial) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Returns the device in \a row.
+ */
+libopenrazer::Device *DeviceListModel::device(int row) const
+{
+    return entries.value(row).device;
+}
+
+/**
+ * Shows the image in \a filename, downloaded from \a url, for all devices using it once its thumbnail is loaded.
+ */
+void DeviceListModel::setImageFile(const QUrl & /* url */, const QString &filename)
+{
+    // The file was (re)downloaded, so a thumbnail in memory is outdated
+    ThumbnailCache::instance()->invalidate(filename);
+    ThumbnailCache::instance()->request(filename);
+}
+
+/**
+ * Shows \a text instead of an image for all devices whose image is behind \a url.
+ */
+void DeviceListModel::setImageText(const QUrl &url, const QString &text)
+{
+    for(int row=0; row<entries.size(); row++) {
+        if(entries[row].imageUrl != url) {
+            continue;
+        }
+        entries[row].image = QPixmap();
+        entries[row].imageText = text;
+        emit dataChanged(index(row), index(row), QVector<int>() << Qt::DecorationRole << ImageTextRole);
+    }
+}
+
+void DeviceListModel::thumbnailReady(const QString &filename, const QPixmap &thumbnail)
+{
+    for(int row=0; row<entries.size(); row++) {
+        if(entries[row].imageUrl.isEmpty() || RazerImageDownloader::getFilePath(entries[row].imageUrl) != filename) {
+            continue;
+        }
+        entries[row].image = thumbnail;
+        entries[row].imageText = QString();
+        emit dataChanged(index(row), index(row), QVector<int>() << Qt::DecorationRole << ImageTextRole);
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DEVICELISTMODEL_H
+#define DEVICELISTMODEL_H
+
+#include <libopenrazer.h>
+#include <QAbstractListModel>
+#include <QPixmap>
+#include <QUrl>
+
+class DeviceListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    // Text shown instead of the image, e.g. while it's downloading
+    enum Roles { ImageTextRole = Qt::UserRole };
+
+    DeviceListModel(QObject *parent = 0);
+    ~DeviceListModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void addDevice(libopenrazer::Device *device);
+    void removeDevice(int row);
+    void clear();
+
+    int indexOf(const QString &serial) const;
+    libopenrazer::Device *device(int row) const;
+
+    void setImageFile(const QUrl &url, const QString &filename);
+    void setImageText(const QUrl &url, const QString &text);
+private:
+    void thumbnailReady(const QString &filename, const QPixmap &thumbnail);
+
+    struct Entry {
+        libopenrazer::Device *device;
+        QString serial;
+        QString name;
+        QUrl imageUrl;
+        QPixmap image;
+        QString imageText;
+    };
+    QList<Entry> entries;
+};
+
+#endif // DEVICELISTMODEL_H
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QCoreApplication>
+#include <QDBusPendingCallWatcher>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+
+#include "callpolicy.h"
+
+// Error name of calls failed by the open circuit breaker
+#define CIRCUIT_OPEN_ERROR "org.razer.libopenrazer.CircuitOpen"
+
+namespace libopenrazer
+{
+
+// Defined in libopenrazer.cpp
+QDBusPendingCall QDBusMessageToPendingCall(const QDBusMessage &message);
+
+/*!
+ * \enum libopenrazer::CallError
+ *
+ * This enum type specifies why a D-Bus call to the daemon failed.
+ *
+ * \value NoError
+ *        The call succeeded.
+ * \value Timeout
+ *        The daemon didn't reply within the timeout of the CallPolicy.
+ * \value DaemonUnavailable
+ *        The daemon is not running or the connection to it was lost.
+ * \value CircuitOpen
+ *        The call wasn't sent because the previous calls failed, see CallPolicy.
+ * \value InvalidArguments
+ *        The daemon rejected the arguments of the call.
+ * \value Failed
+ *        The call failed for another reason, e.g. an exception in the daemon.
+ */
+
+/*!
+ * \struct libopenrazer::CallPolicy
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::CallPolicy struct configures how long calls to the daemon may take and what happens when they fail.
+ *
+ * Every call gets \c timeout milliseconds to be answered. Calls failing because the daemon isn't reachable are retried up to \c retries times,
+ * \c retryBackoff milliseconds after the first failure and twice as long after every further one. Timeouts are not retried.
+ * The retries of PendingReply::then() and of calls queued with queueCall() are scheduled with a timer in the event loop of their thread.
+ * A reply waited for in another thread than the main one is retried while waiting. Waiting in the main thread doesn't retry, sleeping for the backoff would freeze the GUI.
+ *
+ * After \c breakerThreshold calls in a row timed out or didn't reach the daemon, the circuit breaker opens: calls fail immediately with CircuitOpen instead of being sent.
+ * After \c breakerCooldown milliseconds the breaker is half-open: a single call is sent as a probe while the others still fail immediately.
+ * The probe succeeding closes the breaker, failing opens it again. If nobody waits for the result of the probe, another one is let through once it must have timed out.
+ * A hanging or dead daemon then costs a few timeouts instead of one for every call.
+ *
+ * The synchronous methods still return their old values for failed calls, e.g. \c false, \c 0 or an empty string, so existing callers keep working.
+ * The reason a call failed is reported separately by lastCallError() and PendingReply::callError().
+ */
+CallPolicy::CallPolicy() : timeout(3000), retries(2), retryBackoff(50), breakerThreshold(3), breakerCooldown(5000)
+{
+}
+
+static QMutex policyMutex;
+static CallPolicy policy;
+static int consecutiveFailures = 0;
+static qint64 openUntil = 0;
+// While the breaker is half-open, no further probe is sent before this time
+static qint64 probeUntil = 0;
+static thread_local CallError lastError = NoError;
+
+/**
+ * Returns a monotonic time in milliseconds.
+ */
+static qint64 now()
+{
+    static QElapsedTimer timer;
+    if(!timer.isValid()) {
+        timer.start();
+    }
+    return timer.elapsed();
+}
+
+/*!
+ * \fn CallPolicy libopenrazer::callPolicy()
+ *
+ * Returns the policy used for calls to the daemon.
+ */
+CallPolicy callPolicy()
+{
+    QMutexLocker locker(&policyMutex);
+    return policy;
+}
+
+/*!
+ * \fn void libopenrazer::setCallPolicy(const CallPolicy &policy)
+ *
+ * Sets the \a policy used for calls to the daemon.
+ */
+void setCallPolicy(const CallPolicy &newPolicy)
+{
+    QMutexLocker locker(&policyMutex);
+    policy = newPolicy;
+}
+
+/*!
+ * \fn void libopenrazer::resetCircuitBreaker()
+ *
+ * Closes the circuit breaker, e.g. after the daemon was restarted.
+ */
+void resetCircuitBreaker()
+{
+    QMutexLocker locker(&policyMutex);
+    consecutiveFailures = 0;
+    openUntil = 0;
+    probeUntil = 0;
+}
+
+/*!
+ * \fn bool libopenrazer::isCircuitOpen()
+ *
+ * Returns if calls to the daemon currently fail immediately because of previous failures.
+ */
+bool isCircuitOpen()
+{
+    QMutexLocker locker(&policyMutex);
+    qint64 t = now();
+    return consecutiveFailures >= policy.breakerThreshold && (t < openUntil || t < probeUntil);
+}
+
+/**
+ * Returns if a call may be sent or the circuit breaker is open. While it is half-open, only the first caller gets to send its call as the probe.
+ */
+bool allowCall()
+{
+    QMutexLocker locker(&policyMutex);
+    if(consecutiveFailures < policy.breakerThreshold) {
+        return true;
+    }
+    qint64 t = now();
+    if(t < openUntil || t < probeUntil) {
+        return false;
+    }
+    // The result of the probe decides, see recordCallResult()
+    probeUntil = t + policy.timeout;
+    return true;
+}
+
+/**
+ * Updates the circuit breaker with the result of a finished call.
+ */
+void recordCallResult(CallError error)
+{
+    QMutexLocker locker(&policyMutex);
+    if(error == Timeout || error == DaemonUnavailable) {
+        consecutiveFailures++;
+        if(consecutiveFailures >= policy.breakerThreshold) {
+            if(consecutiveFailures == policy.breakerThreshold) {
+                qWarning() << "libopenrazer: The daemon is not responding, failing calls for" << policy.breakerCooldown << "ms.";
+            }
+            openUntil = now() + policy.breakerCooldown;
+        }
+        probeUntil = 0;
+    } else if(error != CircuitOpen) {
+        // The daemon answered, even if it is an error
+        consecutiveFailures = 0;
+        probeUntil = 0;
+    }
+}
+
+/*!
+ * \fn CallError libopenrazer::toCallError(const QDBusError &error)
+ *
+ * Returns the type of the D-Bus \a error.
+ */
+CallError toCallError(const QDBusError &error)
+{
+    switch(error.type()) {
+    case QDBusError::NoError:
+        return NoError;
+    case QDBusError::NoReply:
+    case QDBusError::Timeout:
+    case QDBusError::TimedOut:
+        return Timeout;
+    case QDBusError::ServiceUnknown:
+    case QDBusError::NoServer:
+    case QDBusError::Disconnected:
+        return DaemonUnavailable;
+    case QDBusError::InvalidArgs:
+    case QDBusError::InvalidSignature:
+        return InvalidArguments;
+    default:
+        if(error.name() == CIRCUIT_OPEN_ERROR) {
+            return CircuitOpen;
+        }
+        return Failed;
+    }
+}
+
+/*!
+ * \fn CallError libopenrazer::lastCallError()
+ *
+ * Returns the result of the last call whose reply was waited for in the current thread, e.g. by a synchronous Device method, or handed to a PendingReply::then() callback.
+ * Use it to tell a failed call apart from a call returning \c false, \c 0 or an empty string, the synchronous methods keep returning those on purpose.
+ */
+CallError lastCallError()
+{
+    return lastError;
+}
+
+/**
+ * Returns if the current thread is the main one, which must not sleep.
+ */
+static bool isMainThread()
+{
+    return QCoreApplication::instance() != NULL && QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+/**
+ * Returns how long to wait before retry number \a attempt, counted from 0.
+ */
+int retryDelay(int attempt)
+{
+    return callPolicy().retryBackoff << attempt;
+}
+
+/**
+ * Returns if \a message, whose last attempt \a attempt failed with \a error, should be sent again.
+ */
+bool shouldRetry(const QDBusMessage &message, CallError error, int attempt)
+{
+    return message.type() == QDBusMessage::MethodCallMessage && error == DaemonUnavailable && attempt < callPolicy().retries;
+}
+
+/**
+ * Waits for \a call to finish, retrying \a message according to the call policy if the daemon wasn't reachable.
+ * The main thread doesn't retry, see CallPolicy.
+ */
+void finishPendingCall(const QDBusMessage &message, QDBusPendingCall *call)
+{
+    CallPolicy p = callPolicy();
+    call->waitForFinished();
+    CallError error = toCallError(call->error());
+    // Calls completed locally (e.g. rejected arguments) say nothing about the daemon
+    bool sent = message.type() == QDBusMessage::MethodCallMessage;
+    if(sent) {
+        recordCallResult(error);
+    }
+
+    int backoff = p.retryBackoff;
+    for(int attempt = 0; !isMainThread() && shouldRetry(message, error, attempt); attempt++) {
+        QThread::msleep(backoff);
+        backoff *= 2;
+        *call = QDBusMessageToPendingCall(message);
+        call->waitForFinished();
+        error = toCallError(call->error());
+        recordCallResult(error);
+    }
+    lastError = error;
+}
+
+/**
+ * Calls \a finished with \a call once it finished, in the thread of \a context. If the daemon wasn't reachable, \a message is sent again according to the call policy,
+ * after a timer ran out in the event loop instead of sleeping. \a attempt is the number of retries done so far.
+ */
+void watchPendingCall(const QDBusMessage &message, const QDBusPendingCall &call, QObject *context, const std::function<void(const QDBusPendingCall &call)> &finished, int attempt)
+{
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, context);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context, [message, context, finished, attempt](QDBusPendingCallWatcher *w) {
+        w->deleteLater();
+        QDBusPendingCall call = *w;
+        CallError error = toCallError(call.error());
+        if(message.type() == QDBusMessage::MethodCallMessage) {
+            recordCallResult(error);
+        }
+        if(!shouldRetry(message, error, attempt)) {
+            lastError = error;
+            finished(call);
+            return;
+        }
+        QTimer::singleShot(retryDelay(attempt), context, [message, context, finished, attempt]() {
+            watchPendingCall(message, QDBusMessageToPendingCall(message), context, finished, attempt + 1);
+        });
+    });
+}
+
+/**
+ * Returns an already failed call, for calls not sent because the circuit breaker is open.
+ */
+QDBusPendingCall circuitOpenCall()
+{
+    return QDBusPendingCall::fromError(QDBusMessage::createError(CIRCUIT_OPEN_ERROR, "The daemon did not respond to the previous calls"));
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CALLPOLICY_H
+#define CALLPOLICY_H
+
+#include <functional>
+
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QObject>
+
+namespace libopenrazer
+{
+enum CallError { NoError, Timeout, DaemonUnavailable, CircuitOpen, InvalidArguments, Failed };
+
+struct CallPolicy {
+    CallPolicy();
+
+    int timeout;
+    int retries;
+    int retryBackoff;
+    int breakerThreshold;
+    int breakerCooldown;
+};
+
+CallPolicy callPolicy();
+void setCallPolicy(const CallPolicy &policy);
+void resetCircuitBreaker();
+bool isCircuitOpen();
+
+CallError toCallError(const QDBusError &error);
+CallError lastCallError();
+
+// Internal, used by PendingReply and the call helpers
+bool allowCall();
+QDBusPendingCall circuitOpenCall();
+void recordCallResult(CallError error);
+void finishPendingCall(const QDBusMessage &message, QDBusPendingCall *call);
+int retryDelay(int attempt);
+bool shouldRetry(const QDBusMessage &message, CallError error, int attempt);
+void watchPendingCall(const QDBusMessage &message, const QDBusPendingCall &call, QObject *context, const std::function<void(const QDBusPendingCall &call)> &finished, int attempt = 0);
+}
+
+#endif // CALLPOLICY_H
@@ -0,0 +1,182 @@
+#include "libopenrazer.h"
+#include "standinservice.h"
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QTimer>
+
+// Injects the faults the call policy is there for with a stand-in daemon: a daemon that doesn't answer, and one that isn't on the bus (yet).
+// Checks the retries, the circuit breaker with its single half-open probe and what lastCallError() reports.
+
+#define VERSION "9.9.9"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what)
+{
+    if(!condition) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Handles events until done returns true or ms milliseconds passed
+static bool waitFor(const std::function<bool()> &done, int ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(!done() && timer.elapsed() < ms) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return done();
+}
+
+static void setPolicy(int timeout, int retries, int retryBackoff, int breakerThreshold, int breakerCooldown)
+{
+    libopenrazer::CallPolicy p;
+    p.timeout = timeout;
+    p.retries = retries;
+    p.retryBackoff = retryBackoff;
+    p.breakerThreshold = breakerThreshold;
+    p.breakerCooldown = breakerCooldown;
+    libopenrazer::setCallPolicy(p);
+    libopenrazer::resetCircuitBreaker();
+}
+
+// Gets the daemon version synchronously in a thread of its own
+class VersionThread : public QThread
+{
+public:
+    QString version;
+    libopenrazer::CallError error;
+
+    void run() override
+    {
+        version = libopenrazer::getDaemonVersion();
+        error = libopenrazer::lastCallError();
+    }
+};
+
+// Waiting in the main thread must not sleep for the backoff, the call fails right away
+static void testMainThreadDoesNotSleep(StandInService *daemon)
+{
+    setPolicy(500, 2, 1000, 100, 1000);
+    daemon->setRegistered(false);
+    QElapsedTimer timer;
+    timer.start();
+    QString version = libopenrazer::getDaemonVersion();
+    check(version.isEmpty(), "main thread: the call to a missing daemon returns the old empty string");
+    check(libopenrazer::lastCallError() == libopenrazer::DaemonUnavailable, "main thread: lastCallError() is DaemonUnavailable");
+    check(timer.elapsed() < 1000, "main thread: waiting doesn't sleep for the backoff");
+    daemon->setRegistered(true);
+}
+
+// Other threads retry while waiting, reaching the daemon once it is back
+static void testThreadRetries(StandInService *daemon)
+{
+    setPolicy(500, 2, 300, 100, 1000);
+    daemon->setRegistered(false);
+    daemon->clearCalls();
+    VersionThread thread;
+    thread.start();
+    QTimer::singleShot(100, [daemon]() {
+        daemon->setRegistered(true);
+    });
+    waitFor([&thread]() {
+        return thread.isFinished();
+    }, 5000);
+    check(thread.version == VERSION, "thread: the retry reaches the daemon");
+    check(thread.error == libopenrazer::NoError, "thread: lastCallError() is NoError after the retry");
+    check(daemon->calls().size() == 1, "thread: the daemon gets the call once");
+}
+
+// then() retries from the event loop
+static void testThenRetries(StandInService *daemon)
+{
+    setPolicy(500, 2, 300, 100, 1000);
+    daemon->setRegistered(false);
+    QObject context;
+    QString version;
+    bool called = false;
+    libopenrazer::getDaemonVersionAsync().then(&context, [&version, &called](const QString &v) {
+        version = v;
+        called = true;
+    });
+    QTimer::singleShot(100, [daemon]() {
+        daemon->setRegistered(true);
+    });
+    waitFor([&called]() {
+        return called;
+    }, 5000);
+    check(called, "then(): the callback is called");
+    check(version == VERSION, "then(): the retry reaches the daemon");
+}
+
+// Timeouts open the breaker, after the cooldown a single probe decides
+static void testCircuitBreaker(StandInService *daemon, QAtomicInt *answering)
+{
+    setPolicy(200, 0, 100, 2, 400);
+    answering->store(0);
+    daemon->clearCalls();
+    for(int i=0; i<2; i++) {
+        libopenrazer::getDaemonVersion();
+        check(libopenrazer::lastCallError() == libopenrazer::Timeout, "breaker: a hanging daemon times out");
+    }
+    check(libopenrazer::isCircuitOpen(), "breaker: opens after the threshold");
+    QElapsedTimer timer;
+    timer.start();
+    libopenrazer::getDaemonVersion();
+    check(libopenrazer::lastCallError() == libopenrazer::CircuitOpen, "breaker: calls fail with CircuitOpen while open");
+    check(timer.elapsed() < 100, "breaker: calls fail right away while open");
+
+    // Half-open: the first call is the probe, the others still fail
+    QThread::msleep(450);
+    check(!libopenrazer::isCircuitOpen(), "breaker: half-open after the cooldown");
+    libopenrazer::PendingReply<QString> probe = libopenrazer::getDaemonVersionAsync();
+    libopenrazer::PendingReply<QString> second = libopenrazer::getDaemonVersionAsync();
+    check(second.isFinished() && second.callError() == libopenrazer::CircuitOpen, "breaker: only one probe while half-open");
+    check(libopenrazer::isCircuitOpen(), "breaker: isCircuitOpen() while the probe is out");
+    probe.waitForFinished();
+    check(probe.callError() == libopenrazer::Timeout, "breaker: the probe times out");
+    check(libopenrazer::isCircuitOpen(), "breaker: the failed probe opens it again");
+    check(daemon->calls().size() == 3, "breaker: the daemon gets the two calls and the probe only");
+
+    // A successful probe closes it
+    answering->store(1);
+    QThread::msleep(450);
+    check(libopenrazer::getDaemonVersion() == VERSION, "breaker: the probe reaches the daemon");
+    check(!libopenrazer::isCircuitOpen(), "breaker: the successful probe closes it");
+    check(libopenrazer::getDaemonVersion() == VERSION, "breaker: calls are sent again once closed");
+    check(daemon->calls().size() == 5, "breaker: the daemon gets the probe and the next call");
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if(!hasSessionBus()) {
+        return TEST_SKIPPED;
+    }
+
+    StandInService daemon("org.razer", "/org/razer");
+    QAtomicInt answering(1);
+    daemon.handle("razer.daemon", "version", [&answering](const QDBusMessage &call) {
+        return answering.load() ? call.createReply(QString(VERSION)) : QDBusMessage();
+    });
+    if(!daemon.start()) {
+        return 1;
+    }
+
+    testMainThreadDoesNotSleep(&daemon);
+    testThreadRetries(&daemon);
+    testThenRetries(&daemon);
+    testCircuitBreaker(&daemon, &answering);
+
+    daemon.stop();
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed.\n", failures);
+        return 1;
+    }
+    qDebug() << "All checks passed.";
+    return 0;
+}
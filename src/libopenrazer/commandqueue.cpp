@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "commandqueue.h"
+#include "iothread.h"
+
+namespace libopenrazer
+{
+
+/*!
+ * \class libopenrazer::CommandQueue
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::CommandQueue class sends setter calls so that only the latest value of every setting reaches the daemon.
+ *
+ * Calls are grouped by their interface and method. At most one call of a group is sent at a time. A call made while another one of the same group is still waiting for its reply is held back,
+ * and replaced if yet another call of the group comes in before it could be sent. Dragging a slider then sends as many values as the daemon can keep up with, and always the last one.
+ *
+ * Every Device has one for its \c ...Queued() setters, see Device::commandQueue(). The calls are queued as InteractiveCall, see queueCall().
+ */
+
+/*!
+ * \fn libopenrazer::CommandQueue::CommandQueue(QObject *parent)
+ *
+ * Constructs an empty queue with the given \a parent.
+ */
+CommandQueue::CommandQueue(QObject *parent) : QObject(parent), mCoalescedCount(0)
+{
+    qRegisterMetaType<QDBusMessage>();
+    qRegisterMetaType<libopenrazer::CallCallback>("libopenrazer::CallCallback");
+}
+
+CommandQueue::~CommandQueue()
+{
+}
+
+/*!
+ * \fn void libopenrazer::CommandQueue::send(const QDBusMessage &message, const libopenrazer::CallCallback &finished)
+ *
+ * Sends \a message, or holds it back until the previous call to the same method got its reply. Replaces a held back call to the same method.
+ * If given, \a finished is called with the reply in the thread of the queue. It isn't called if the message got replaced before it was sent.
+ * Can be called from any thread, the call is passed on to the thread of the queue then.
+ */
+void CommandQueue::send(const QDBusMessage &message, const CallCallback &finished)
+{
+    if(QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "send", Qt::QueuedConnection, Q_ARG(QDBusMessage, message), Q_ARG(libopenrazer::CallCallback, finished));
+        return;
+    }
+    QString key = message.interface() + "." + message.member();
+    Command command = { message, finished };
+    QMutexLocker locker(&mutex);
+    if(!inFlightKeys.contains(key)) {
+        inFlightKeys.insert(key);
+        locker.unlock();
+        dispatch(key, command);
+        return;
+    }
+    if(pending.contains(key)) {
+        mCoalescedCount++;
+    }
+    pending.insert(key, command);
+}
+
+/**
+ * Sends the call and keeps track of it until the reply arrives. The key has to be marked in flight already.
+ */
+void CommandQueue::dispatch(const QString &key, const Command &command)
+{
+    CallCallback finished = command.finished;
+    queueCall(command.message, InteractiveCall, this, [this, key, finished](const QDBusMessage &reply) {
+        callFinished(key, finished, reply);
+    });
+}
+
+/**
+ * Reports a failed call and sends the call held back in the meantime.
+ */
+void CommandQueue::callFinished(const QString &key, const CallCallback &finished, const QDBusMessage &reply)
+{
+    {
+        QMutexLocker locker(&mutex);
+        inFlightKeys.remove(key);
+    }
+
+    if(reply.type() == QDBusMessage::ErrorMessage) {
+        QDBusError error(reply);
+        qWarning() << "libopenrazer: Queued call" << key << "failed:" << error.message();
+        emit commandFailed(key, error);
+    }
+    if(finished) {
+        finished(reply);
+    }
+
+    QMutexLocker locker(&mutex);
+    QHash<QString, Command>::iterator it = pending.find(key);
+    if(it != pending.end()) {
+        Command command = *it;
+        pending.erase(it);
+        inFlightKeys.insert(key);
+        locker.unlock();
+        dispatch(key, command);
+    }
+}
+
+/*!
+ * \fn int libopenrazer::CommandQueue::pendingCount() const
+ *
+ * Returns the number of calls held back. Like inFlightCount() and coalescedCount(), it can be called from any thread.
+ */
+int CommandQueue::pendingCount() const
+{
+    QMutexLocker locker(&mutex);
+    return pending.size();
+}
+
+/*!
+ * \fn int libopenrazer::CommandQueue::inFlightCount() const
+ *
+ * Returns the number of calls sent but not answered yet.
+ */
+int CommandQueue::inFlightCount() const
+{
+    QMutexLocker locker(&mutex);
+    return inFlightKeys.size();
+}
+
+/*!
+ * \fn quint64 libopenrazer::CommandQueue::coalescedCount() const
+ *
+ * Returns the number of calls that were replaced by a newer call before they were sent.
+ */
+quint64 CommandQueue::coalescedCount() const
+{
+    QMutexLocker locker(&mutex);
+    return mCoalescedCount;
+}
+
+/*!
+ * \fn void libopenrazer::CommandQueue::commandFailed(const QString &method, const QDBusError &error)
+ *
+ * This signal is emitted when the call to \a method, including its interface, failed with \a error.
+ */
+
+}
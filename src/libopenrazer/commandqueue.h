@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+
+#include "iothread.h"
+
+namespace libopenrazer
+{
+class CommandQueue : public QObject
+{
+    Q_OBJECT
+public:
+    CommandQueue(QObject *parent = 0);
+    ~CommandQueue();
+
+    Q_INVOKABLE void send(const QDBusMessage &message, const libopenrazer::CallCallback &finished = libopenrazer::CallCallback());
+
+    int pendingCount() const;
+    int inFlightCount() const;
+    quint64 coalescedCount() const;
+signals:
+    void commandFailed(const QString &method, const QDBusError &error);
+private:
+    struct Command {
+        QDBusMessage message;
+        CallCallback finished;
+    };
+    void dispatch(const QString &key, const Command &command);
+    void callFinished(const QString &key, const CallCallback &finished, const QDBusMessage &reply);
+
+    // Guards the members below, the counters are read from other threads
+    mutable QMutex mutex;
+    QHash<QString, Command> pending;
+    QSet<QString> inFlightKeys;
+    quint64 mCoalescedCount;
+};
+}
+
+#endif // COMMANDQUEUE_H
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QPointer>
+#include <QSharedPointer>
+
+#include "devicebatch.h"
+
+namespace libopenrazer
+{
+
+// Defined in libopenrazer.cpp
+QDBusPendingCall QDBusMessageToPendingCall(const QDBusMessage &message);
+
+/*!
+ * \class libopenrazer::DeviceBatch
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::DeviceBatch class collects calls to a device and sends them together.
+ *
+ * Calls added to a batch are not sent right away. commit() and exec() send all of them back to back without waiting for the replies in between,
+ * so applying a whole configuration costs about one round trip to the daemon instead of one per setting:
+ *
+ * \code
+ * device->batch().setStatic(Qt::green).setLogoBrightness(50).setLogoActive(true).setDPI(800, 800).commit(this, [](const QList<BatchResult> &results) {
+ *     ...
+ * });
+ * \endcode
+ *
+ * There is one result for every D-Bus call, in the order the calls were added. The calls are sent as InteractiveCall, see queueCall().
+ * Adding a call has no side effects. Like with the \c ...Async() setters, properties() of the device are updated once a call succeeded, and effects make the next matrix frame get sent completely.
+ * Matrix frames can't be added: the device only sends the rows that changed since the last frame, which a batch sent later or dropped would get wrong.
+ * Device::setMatrixFrameAsync() fails with \c QDBusError::NotSupported in a batch, use it or a FrameStream directly.
+ * The device has to exist until every call got its reply.
+ */
+
+/*!
+ * \struct libopenrazer::BatchResult
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::BatchResult struct holds the result of one call of a DeviceBatch.
+ *
+ * \c method is the D-Bus interface and method of the call, empty if the call failed before being sent. \c error and \c dbusError tell if and why it failed.
+ */
+
+/*!
+ * \fn libopenrazer::DeviceBatch::DeviceBatch(Device *device)
+ *
+ * Constructs an empty batch of calls to \a device. Usually created with Device::batch().
+ */
+DeviceBatch::DeviceBatch(Device *device) : device(device)
+{
+}
+
+/*!
+ * \fn template<typename T, typename... Params, typename... Args> DeviceBatch &libopenrazer::DeviceBatch::call(PendingReply<T> (Device::*method)(Params...), Args&&... args)
+ *
+ * Adds the calls the \c ...Async() \a method of the device makes with \a args, e.g. \c {call(&Device::setWaveAsync, WAVE_RIGHT)}.
+ * If the method fails without sending anything, e.g. because of invalid arguments or for matrix frames, the failure is part of the results.
+ */
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setStatic(QColor color)
+ *
+ * Adds Device::setStatic() with \a color.
+ */
+DeviceBatch &DeviceBatch::setStatic(QColor color)
+{
+    return call(&Device::setStaticAsync, color);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setLogoStatic(QColor color)
+ *
+ * Adds Device::setLogoStatic() with \a color.
+ */
+DeviceBatch &DeviceBatch::setLogoStatic(QColor color)
+{
+    return call(&Device::setLogoStaticAsync, color);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setScrollStatic(QColor color)
+ *
+ * Adds Device::setScrollStatic() with \a color.
+ */
+DeviceBatch &DeviceBatch::setScrollStatic(QColor color)
+{
+    return call(&Device::setScrollStaticAsync, color);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setBacklightStatic(QColor color)
+ *
+ * Adds Device::setBacklightStatic() with \a color.
+ */
+DeviceBatch &DeviceBatch::setBacklightStatic(QColor color)
+{
+    return call(&Device::setBacklightStaticAsync, color);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setBrightness(double brightness)
+ *
+ * Adds Device::setBrightness() with \a brightness.
+ */
+DeviceBatch &DeviceBatch::setBrightness(double brightness)
+{
+    return call(&Device::setBrightnessAsync, brightness);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setLogoBrightness(double brightness)
+ *
+ * Adds Device::setLogoBrightness() with \a brightness.
+ */
+DeviceBatch &DeviceBatch::setLogoBrightness(double brightness)
+{
+    return call(&Device::setLogoBrightnessAsync, brightness);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setScrollBrightness(double brightness)
+ *
+ * Adds Device::setScrollBrightness() with \a brightness.
+ */
+DeviceBatch &DeviceBatch::setScrollBrightness(double brightness)
+{
+    return call(&Device::setScrollBrightnessAsync, brightness);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setBacklightBrightness(double brightness)
+ *
+ * Adds Device::setBacklightBrightness() with \a brightness.
+ */
+DeviceBatch &DeviceBatch::setBacklightBrightness(double brightness)
+{
+    return call(&Device::setBacklightBrightnessAsync, brightness);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setLogoActive(bool active)
+ *
+ * Adds Device::setLogoActive() with \a active.
+ */
+DeviceBatch &DeviceBatch::setLogoActive(bool active)
+{
+    return call(&Device::setLogoActiveAsync, active);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setScrollActive(bool active)
+ *
+ * Adds Device::setScrollActive() with \a active.
+ */
+DeviceBatch &DeviceBatch::setScrollActive(bool active)
+{
+    return call(&Device::setScrollActiveAsync, active);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setBacklightActive(bool active)
+ *
+ * Adds Device::setBacklightActive() with \a active.
+ */
+DeviceBatch &DeviceBatch::setBacklightActive(bool active)
+{
+    return call(&Device::setBacklightActiveAsync, active);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setDPI(int dpi_x, int dpi_y)
+ *
+ * Adds Device::setDPI() with \a dpi_x and \a dpi_y.
+ */
+DeviceBatch &DeviceBatch::setDPI(int dpi_x, int dpi_y)
+{
+    return call(&Device::setDPIAsync, dpi_x, dpi_y);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setPollRate(PollRate pollrate)
+ *
+ * Adds Device::setPollRate() with \a pollrate.
+ */
+DeviceBatch &DeviceBatch::setPollRate(PollRate pollrate)
+{
+    return call(&Device::setPollRateAsync, pollrate);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setRedLED(bool on)
+ *
+ * Adds Device::setRedLED() with \a on.
+ */
+DeviceBatch &DeviceBatch::setRedLED(bool on)
+{
+    return call(&Device::setRedLEDAsync, on);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setGreenLED(bool on)
+ *
+ * Adds Device::setGreenLED() with \a on.
+ */
+DeviceBatch &DeviceBatch::setGreenLED(bool on)
+{
+    return call(&Device::setGreenLEDAsync, on);
+}
+
+/*!
+ * \fn DeviceBatch &libopenrazer::DeviceBatch::setBlueLED(bool on)
+ *
+ * Adds Device::setBlueLED() with \a on.
+ */
+DeviceBatch &DeviceBatch::setBlueLED(bool on)
+{
+    return call(&Device::setBlueLEDAsync, on);
+}
+
+/*!
+ * \fn int libopenrazer::DeviceBatch::size() const
+ *
+ * Returns the number of D-Bus calls in the batch. Some methods, like Device::setMatrixFrameAsync(), make more than one.
+ */
+int DeviceBatch::size() const
+{
+    return messages.size();
+}
+
+/*!
+ * \fn bool libopenrazer::DeviceBatch::isEmpty() const
+ *
+ * Returns if no calls were added.
+ */
+bool DeviceBatch::isEmpty() const
+{
+    return messages.isEmpty();
+}
+
+/**
+ * Returns the result of the call \a message which got \a reply.
+ */
+BatchResult DeviceBatch::toResult(const QDBusMessage &message, const QDBusMessage &reply)
+{
+    BatchResult r;
+    if(message.type() == QDBusMessage::MethodCallMessage) {
+        r.method = message.interface() + "." + message.member();
+    }
+    r.dbusError = QDBusError(reply);
+    r.error = toCallError(r.dbusError);
+    return r;
+}
+
+/*!
+ * \fn void libopenrazer::DeviceBatch::commit(QObject *context, const BatchCallback &callback)
+ *
+ * Sends all calls without blocking and empties the batch. Once every call got its reply, \a callback is called with the results, unless \a context has been destroyed by then.
+ * If nothing has to be sent, \a callback is called right away.
+ */
+void DeviceBatch::commit(QObject *context, const BatchCallback &callback)
+{
+    // The replies are applied to the device even if the context is gone
+    bool guarded = context != NULL;
+    QPointer<QObject> guard(context);
+    struct State {
+        QList<BatchResult> results;
+        int remaining;
+    };
+    QSharedPointer<State> state(new State);
+    state->remaining = 0;
+    for(const QDBusMessage &message : messages) {
+        state->results.append(toResult(message, message));
+        if(message.type() == QDBusMessage::MethodCallMessage) {
+            state->remaining++;
+        }
+    }
+
+    QList<QDBusMessage> sent = messages;
+    QList<CallCallback> sentHandlers = handlers;
+    messages.clear();
+    handlers.clear();
+    if(state->remaining == 0) {
+        if(callback) {
+            callback(state->results);
+        }
+        return;
+    }
+    for(int i=0; i<sent.size(); i++) {
+        if(sent[i].type() != QDBusMessage::MethodCallMessage) {
+            continue;
+        }
+        QDBusMessage message = sent[i];
+        CallCallback handler = sentHandlers[i];
+        queueCall(message, InteractiveCall, NULL, [state, i, message, handler, callback, guarded, guard](const QDBusMessage &reply) {
+            if(handler) {
+                handler(reply);
+            }
+            state->results[i] = toResult(message, reply);
+            if(--state->remaining == 0 && callback && (!guarded || guard)) {
+                callback(state->results);
+            }
+        });
+    }
+}
+
+/*!
+ * \fn QList<BatchResult> libopenrazer::DeviceBatch::exec()
+ *
+ * Sends all calls, empties the batch and blocks until every call got its reply. Returns the results.
+ */
+QList<BatchResult> DeviceBatch::exec()
+{
+    QList<QDBusPendingCall> calls;
+    for(const QDBusMessage &message : messages) {
+        if(message.type() == QDBusMessage::MethodCallMessage) {
+            calls.append(QDBusMessageToPendingCall(message));
+        } else {
+            calls.append(QDBusPendingCall::fromCompletedCall(message));
+        }
+    }
+
+    QList<BatchResult> results;
+    for(int i=0; i<calls.size(); i++) {
+        finishPendingCall(messages[i], &calls[i]);
+        if(handlers[i]) {
+            handlers[i](calls[i].reply());
+        }
+        results.append(toResult(messages[i], calls[i].reply()));
+    }
+    messages.clear();
+    handlers.clear();
+    return results;
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DEVICEBATCH_H
+#define DEVICEBATCH_H
+
+#include <functional>
+#include <utility>
+
+#include <QColor>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QList>
+#include <QObject>
+
+#include "callpolicy.h"
+#include "iothread.h"
+#include "libopenrazer.h"
+
+namespace libopenrazer
+{
+struct BatchResult {
+    QString method;
+    CallError error;
+    QDBusError dbusError;
+};
+
+typedef std::function<void(const QList<BatchResult> &results)> BatchCallback;
+
+class DeviceBatch
+{
+public:
+    DeviceBatch(Device *device);
+
+    template<typename T, typename... Params, typename... Args>
+    DeviceBatch &call(PendingReply<T> (Device::*method)(Params...), Args&&... args);
+
+    DeviceBatch &setStatic(QColor color);
+    DeviceBatch &setLogoStatic(QColor color);
+    DeviceBatch &setScrollStatic(QColor color);
+    DeviceBatch &setBacklightStatic(QColor color);
+    DeviceBatch &setBrightness(double brightness);
+    DeviceBatch &setLogoBrightness(double brightness);
+    DeviceBatch &setScrollBrightness(double brightness);
+    DeviceBatch &setBacklightBrightness(double brightness);
+    DeviceBatch &setLogoActive(bool active);
+    DeviceBatch &setScrollActive(bool active);
+    DeviceBatch &setBacklightActive(bool active);
+    DeviceBatch &setDPI(int dpi_x, int dpi_y);
+    DeviceBatch &setPollRate(PollRate pollrate);
+    DeviceBatch &setRedLED(bool on);
+    DeviceBatch &setGreenLED(bool on);
+    DeviceBatch &setBlueLED(bool on);
+
+    int size() const;
+    bool isEmpty() const;
+
+    void commit(QObject *context = 0, const BatchCallback &callback = BatchCallback());
+    QList<BatchResult> exec();
+private:
+    static BatchResult toResult(const QDBusMessage &message, const QDBusMessage &reply);
+
+    Device *device;
+    QList<QDBusMessage> messages;
+    QList<CallCallback> handlers;
+};
+
+template<typename T, typename... Params, typename... Args>
+DeviceBatch &DeviceBatch::call(PendingReply<T> (Device::*method)(Params...), Args&&... args)
+{
+    CapturedCalls capture(false);
+    PendingReply<T> reply = (device->*method)(std::forward<Args>(args)...);
+    QList<QDBusMessage> captured = capture.finish();
+    if(captured.isEmpty() && reply.isError()) {
+        // Kept as error reply, so it shows up in the results
+        messages.append(QDBusMessage::createError(reply.error()));
+        handlers.append(CallCallback());
+    }
+    messages.append(captured);
+    handlers.append(capture.replyHandlers());
+    return *this;
+}
+}
+
+#endif // DEVICEBATCH_H
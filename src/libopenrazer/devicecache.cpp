@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "devicecache.h"
+
+namespace libopenrazer
+{
+
+/*!
+ * \class libopenrazer::DeviceCache
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::DeviceCache class stores the capabilities and static information of devices in a file, so they don't have to be queried from the daemon on every start.
+ *
+ * Pass the cache to the Device constructor. A device found in the cache skips the introspection, the information of a new device gets added to the cache.
+ * Entries are stored per device serial together with the VID and PID of the device. The whole cache is dropped when the daemon version changes, as a new daemon can support more features.
+ *
+ * Changes are only written to the file with save(). The methods can be called from any thread, so one cache can be shared by devices used in different threads.
+ */
+
+/*!
+ * \fn libopenrazer::DeviceCache::DeviceCache(const QString &filename, const QString &daemonVersion)
+ *
+ * Constructs a cache stored in \a filename and loads it. Entries written by a daemon version other than \a daemonVersion are discarded.
+ */
+DeviceCache::DeviceCache(const QString &filename, const QString &daemonVersion) : mFilename(filename), mDaemonVersion(daemonVersion), dirty(false)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if(root.value("daemon_version").toString() != daemonVersion) {
+        // Written by another daemon version, rewrite the file with the next save
+        dirty = true;
+        return;
+    }
+    devices = root.value("devices").toObject();
+}
+
+DeviceCache::~DeviceCache()
+{
+}
+
+/*!
+ * \fn QString libopenrazer::DeviceCache::filename() const
+ *
+ * Returns the filename of the cache.
+ */
+QString DeviceCache::filename() const
+{
+    return mFilename;
+}
+
+/*!
+ * \fn QString libopenrazer::DeviceCache::daemonVersion() const
+ *
+ * Returns the daemon version the cache entries are valid for.
+ */
+QString DeviceCache::daemonVersion() const
+{
+    QMutexLocker locker(&mutex);
+    return mDaemonVersion;
+}
+
+/*!
+ * \fn void libopenrazer::DeviceCache::setDaemonVersion(const QString &daemonVersion)
+ *
+ * Sets the daemon version to \a daemonVersion, e.g. after the daemon was restarted. All entries are discarded if the version changed.
+ */
+void DeviceCache::setDaemonVersion(const QString &daemonVersion)
+{
+    QMutexLocker locker(&mutex);
+    if(daemonVersion == mDaemonVersion) {
+        return;
+    }
+    mDaemonVersion = daemonVersion;
+    devices = QJsonObject();
+    dirty = true;
+}
+
+/*!
+ * \fn QJsonObject libopenrazer::DeviceCache::entry(const QString &serial) const
+ *
+ * Returns the entry of the device with the given \a serial, or an empty object if the device is not in the cache.
+ */
+QJsonObject DeviceCache::entry(const QString &serial) const
+{
+    QMutexLocker locker(&mutex);
+    return devices.value(serial).toObject();
+}
+
+/*!
+ * \fn void libopenrazer::DeviceCache::setEntry(const QString &serial, const QJsonObject &entry)
+ *
+ * Sets the entry of the device with the given \a serial to \a entry.
+ */
+void DeviceCache::setEntry(const QString &serial, const QJsonObject &entry)
+{
+    QMutexLocker locker(&mutex);
+    if(devices.value(serial).toObject() == entry) {
+        return;
+    }
+    devices.insert(serial, entry);
+    dirty = true;
+}
+
+/*!
+ * \fn void libopenrazer::DeviceCache::clear()
+ *
+ * Removes all entries.
+ */
+void DeviceCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    devices = QJsonObject();
+    dirty = true;
+}
+
+/*!
+ * \fn bool libopenrazer::DeviceCache::save()
+ *
+ * Writes the cache to the file if it changed since it was loaded or saved last.
+ *
+ * Returns if the cache was written successfully or didn't have to be written.
+ */
+bool DeviceCache::save()
+{
+    QMutexLocker locker(&mutex);
+    if(!dirty) {
+        return true;
+    }
+    QDir().mkpath(QFileInfo(mFilename).absolutePath());
+
+    QJsonObject root;
+    root.insert("daemon_version", mDaemonVersion);
+    root.insert("devices", devices);
+
+    // Write to a temporary file first, so a crash doesn't leave a broken cache behind
+    QSaveFile file(mFilename);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "libopenrazer: Failed to open device cache" << mFilename << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if(!file.commit()) {
+        qWarning() << "libopenrazer: Failed to write device cache" << mFilename << ":" << file.errorString();
+        return false;
+    }
+    dirty = false;
+    return true;
+}
+
+}
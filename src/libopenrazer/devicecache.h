@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2017-2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -16,34 +16,37 @@
  *
  */
 
-#ifndef RAZERCAPABILITY_H
-#define RAZERCAPABILITY_H
+#ifndef DEVICECACHE_H
+#define DEVICECACHE_H
 
+#include <QJsonObject>
+#include <QMutex>
 #include <QString>
-#include <QMetaType>
 
 namespace libopenrazer
 {
-class RazerCapability
+class DeviceCache
 {
 public:
-    RazerCapability();
-    RazerCapability(QString identifier, QString displayString, int numColors);
-    RazerCapability(QString identifier, QString displayString, bool wave);
-    RazerCapability(const RazerCapability &other);
-    ~RazerCapability();
-    int getNumColors() const;
-    QString getIdentifier() const;
-    QString getDisplayString() const;
-    bool isWave() const;
+    DeviceCache(const QString &filename, const QString &daemonVersion);
+    ~DeviceCache();
+
+    QString filename() const;
+    QString daemonVersion() const;
+    void setDaemonVersion(const QString &daemonVersion);
+
+    QJsonObject entry(const QString &serial) const;
+    void setEntry(const QString &serial, const QJsonObject &entry);
+    void clear();
+
+    bool save();
 private:
-    int numColors;
-    QString identifier;
-    QString displayString;
-    bool wave;
+    mutable QMutex mutex;
+    QString mFilename;
+    QString mDaemonVersion;
+    QJsonObject devices;
+    bool dirty;
 };
 }
 
-Q_DECLARE_METATYPE(libopenrazer::RazerCapability)
-
-#endif // RAZERCAPABILITY_H
+#endif // DEVICECACHE_H
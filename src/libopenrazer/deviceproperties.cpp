@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include "deviceproperties.h"
+#include "iothread.h"
+#include "libopenrazer.h"
+
+namespace libopenrazer
+{
+
+/*!
+ * \class libopenrazer::DeviceProperties
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::DeviceProperties class holds the last known values of the settings of a device, like the brightness or DPI.
+ *
+ * Values are fetched from the daemon the first time they are needed and read from memory afterwards, so multiple widgets showing the same setting share one query.
+ * Setting a value through the Device updates it here as well once the daemon confirmed the call, and emits valueChanged(). A failed call forgets the value.
+ * The \c ...Queued() setters of Device update the value right away instead, so it follows a slider while it is dragged, and fetch it again if the call failed.
+ * Use Device::properties() to get the instance of a device.
+ *
+ * Values changed by other applications are not noticed, call refresh() or invalidate() to get them again.
+ *
+ * All methods can be called from any thread. valueChanged() is emitted in the thread that changed the value, for replies of the daemon that is the thread of this object.
+ */
+
+/*!
+ * \enum libopenrazer::DeviceProperties::Property
+ *
+ * This enum type specifies the settings held by DeviceProperties, with the type of their value.
+ *
+ * \value Brightness
+ *        \c double, see Device::getBrightness().
+ * \value LogoBrightness
+ *        \c double, see Device::getLogoBrightness().
+ * \value ScrollBrightness
+ *        \c double, see Device::getScrollBrightness().
+ * \value BacklightBrightness
+ *        \c double, see Device::getBacklightBrightness().
+ * \value LogoActive
+ *        \c bool, see Device::getLogoActive().
+ * \value ScrollActive
+ *        \c bool, see Device::getScrollActive().
+ * \value BacklightActive
+ *        \c bool, see Device::getBacklightActive().
+ * \value RedLED
+ *        \c bool, see Device::getRedLED().
+ * \value GreenLED
+ *        \c bool, see Device::getGreenLED().
+ * \value BlueLED
+ *        \c bool, see Device::getBlueLED().
+ * \value DPI
+ *        \c QList<int>, see Device::getDPI().
+ * \value PollRate
+ *        \c int, see Device::getPollRate().
+ */
+
+/*!
+ * \fn libopenrazer::DeviceProperties::DeviceProperties(Device *device, QObject *parent)
+ *
+ * Constructs the properties of \a device with the given \a parent.
+ */
+DeviceProperties::DeviceProperties(Device *device, QObject *parent) : QObject(parent), device(device)
+{
+    // Emitted from the thread changing a setting
+    qRegisterMetaType<libopenrazer::DeviceProperties::Property>("libopenrazer::DeviceProperties::Property");
+}
+
+DeviceProperties::~DeviceProperties()
+{
+}
+
+/**
+ * Wraps a pending reply, so the value can be read without knowing its type.
+ */
+template<typename T>
+DeviceProperties::Query DeviceProperties::makeQuery(const PendingReply<T> &reply)
+{
+    Query q = { [reply](CallError *error) {
+        QVariant value = QVariant::fromValue(reply.value());
+        *error = reply.callError();
+        return value;
+    }, [reply](const QDBusMessage &m) {
+        return QVariant::fromValue(reply.convert(m));
+    } };
+    return q;
+}
+
+/**
+ * Sends the query for \a property.
+ */
+DeviceProperties::Query DeviceProperties::query(Property property)
+{
+    switch(property) {
+    case Brightness:
+        return makeQuery(device->getBrightnessAsync());
+    case LogoBrightness:
+        return makeQuery(device->getLogoBrightnessAsync());
+    case ScrollBrightness:
+        return makeQuery(device->getScrollBrightnessAsync());
+    case BacklightBrightness:
+        return makeQuery(device->getBacklightBrightnessAsync());
+    case LogoActive:
+        return makeQuery(device->getLogoActiveAsync());
+    case ScrollActive:
+        return makeQuery(device->getScrollActiveAsync());
+    case BacklightActive:
+        return makeQuery(device->getBacklightActiveAsync());
+    case RedLED:
+        return makeQuery(device->getRedLEDAsync());
+    case GreenLED:
+        return makeQuery(device->getGreenLEDAsync());
+    case BlueLED:
+        return makeQuery(device->getBlueLEDAsync());
+    case DPI:
+        return makeQuery(device->getDPIAsync());
+    case PollRate:
+        return makeQuery(device->getPollRateAsync());
+    }
+    // Unknown property
+    Query q = { [](CallError *error) {
+        *error = InvalidArguments;
+        return QVariant();
+    }, [](const QDBusMessage &) {
+        return QVariant();
+    } };
+    return q;
+}
+
+/*!
+ * \fn QVariant libopenrazer::DeviceProperties::value(Property property)
+ *
+ * Returns the value of \a property. If it isn't known yet, it is fetched from the daemon, blocking until the reply arrives.
+ *
+ * Returns an invalid \c QVariant if fetching the value failed.
+ */
+QVariant DeviceProperties::value(Property property)
+{
+    {
+        QMutexLocker locker(&mutex);
+        QHash<int, QVariant>::const_iterator it = values.constFind(property);
+        if(it != values.constEnd()) {
+            return *it;
+        }
+    }
+    Query q = query(property);
+    CallError error;
+    QVariant v = q.value(&error);
+    if(error != NoError) {
+        return QVariant();
+    }
+    update(property, v);
+    return v;
+}
+
+/*!
+ * \fn bool libopenrazer::DeviceProperties::contains(Property property) const
+ *
+ * Returns if the value of \a property is known.
+ */
+bool DeviceProperties::contains(Property property) const
+{
+    QMutexLocker locker(&mutex);
+    return values.contains(property);
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::refresh(libopenrazer::DeviceProperties::Property property)
+ *
+ * Fetches the value of \a property from the daemon without blocking. valueChanged() is emitted once the reply arrived, if the value changed.
+ * The call is queued as BackgroundCall, see queueCall().
+ */
+void DeviceProperties::refresh(Property property)
+{
+    if(QThread::currentThread() != thread()) {
+        // The reply is handled in the thread of this object
+        QMetaObject::invokeMethod(this, "refresh", Qt::QueuedConnection, Q_ARG(libopenrazer::DeviceProperties::Property, property));
+        return;
+    }
+    CapturedCalls capture;
+    Query q = query(property);
+    QList<QDBusMessage> messages = capture.finish();
+    if(messages.isEmpty()) {
+        return;
+    }
+    queueCall(messages.first(), BackgroundCall, this, [this, property, q](const QDBusMessage &reply) {
+        if(reply.type() != QDBusMessage::ErrorMessage) {
+            update(property, q.convert(reply));
+        }
+    });
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::update(Property property, const QVariant &value)
+ *
+ * Sets the known value of \a property to \a value and emits valueChanged() if it changed. Doesn't send anything to the device, this is called by the setters of Device.
+ */
+void DeviceProperties::update(Property property, const QVariant &value)
+{
+    {
+        QMutexLocker locker(&mutex);
+        QHash<int, QVariant>::iterator it = values.find(property);
+        if(it != values.end() && *it == value) {
+            return;
+        }
+        values.insert(property, value);
+    }
+    emit valueChanged(property, value);
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::updateOnReply(const QDBusPendingCall &call, Property property, const QVariant &value)
+ *
+ * Sets the known value of \a property to \a value once the setter \a call succeeded, see applyReply(). This is called by the setters of Device.
+ */
+void DeviceProperties::updateOnReply(const QDBusPendingCall &call, Property property, const QVariant &value)
+{
+    {
+        QMutexLocker locker(&mutex);
+        PendingUpdate u = { call, property, value };
+        pendingUpdates.append(u);
+    }
+    // The calls are watched in the thread of this object, the calling thread might not run an event loop
+    QMetaObject::invokeMethod(this, "watchPendingUpdates", Qt::QueuedConnection);
+}
+
+/**
+ * Watches the calls passed to updateOnReply() until their reply arrives.
+ */
+void DeviceProperties::watchPendingUpdates()
+{
+    QList<PendingUpdate> updates;
+    {
+        QMutexLocker locker(&mutex);
+        updates.swap(pendingUpdates);
+    }
+    foreach(const PendingUpdate &u, updates) {
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(u.call, this);
+        Property property = u.property;
+        QVariant value = u.value;
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, property, value](QDBusPendingCallWatcher *w) {
+            w->deleteLater();
+            applyReply(w->reply(), property, value);
+        });
+    }
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::applyReply(const QDBusMessage &reply, Property property, const QVariant &value)
+ *
+ * Sets the known value of \a property to \a value if \a reply of the setter call is successful. Otherwise the value is forgotten, as it isn't known what the device has now.
+ * An invalid \a value forgets the value as well, for setters leaving the actual value to the daemon.
+ */
+void DeviceProperties::applyReply(const QDBusMessage &reply, Property property, const QVariant &value)
+{
+    if(reply.type() == QDBusMessage::ErrorMessage || !value.isValid()) {
+        invalidate(property);
+    } else {
+        update(property, value);
+    }
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::invalidate(Property property)
+ *
+ * Forgets the value of \a property, so it is fetched again the next time it is needed.
+ */
+void DeviceProperties::invalidate(Property property)
+{
+    QMutexLocker locker(&mutex);
+    values.remove(property);
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::invalidateAll()
+ *
+ * Forgets all values.
+ */
+void DeviceProperties::invalidateAll()
+{
+    QMutexLocker locker(&mutex);
+    values.clear();
+}
+
+/*!
+ * \fn void libopenrazer::DeviceProperties::valueChanged(libopenrazer::DeviceProperties::Property property, const QVariant &value)
+ *
+ * This signal is emitted when the known \a value of \a property changed.
+ */
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DEVICEPROPERTIES_H
+#define DEVICEPROPERTIES_H
+
+#include <functional>
+
+#include <QDBusPendingCall>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QVariant>
+
+#include "pendingreply.h"
+
+namespace libopenrazer
+{
+class Device;
+
+class DeviceProperties : public QObject
+{
+    Q_OBJECT
+public:
+    enum Property {
+        Brightness,
+        LogoBrightness,
+        ScrollBrightness,
+        BacklightBrightness,
+        LogoActive,
+        ScrollActive,
+        BacklightActive,
+        RedLED,
+        GreenLED,
+        BlueLED,
+        DPI,
+        PollRate
+    };
+    Q_ENUM(Property)
+
+    DeviceProperties(Device *device, QObject *parent = 0);
+    ~DeviceProperties();
+
+    QVariant value(Property property);
+    bool contains(Property property) const;
+    Q_INVOKABLE void refresh(libopenrazer::DeviceProperties::Property property);
+    void update(Property property, const QVariant &value);
+    void updateOnReply(const QDBusPendingCall &call, Property property, const QVariant &value);
+    void applyReply(const QDBusMessage &reply, Property property, const QVariant &value);
+    void invalidate(Property property);
+    void invalidateAll();
+signals:
+    void valueChanged(libopenrazer::DeviceProperties::Property property, const QVariant &value);
+private slots:
+    void watchPendingUpdates();
+private:
+    struct PendingUpdate {
+        QDBusPendingCall call;
+        Property property;
+        QVariant value;
+    };
+    struct Query {
+        // Waits for the reply, sets error to the error of the finished (possibly retried) call
+        std::function<QVariant(CallError *error)> value;
+        std::function<QVariant(const QDBusMessage &reply)> convert;
+    };
+    Query query(Property property);
+    template<typename T> static Query makeQuery(const PendingReply<T> &reply);
+
+    Device *device;
+    mutable QMutex mutex;
+    QHash<int, QVariant> values;
+    QList<PendingUpdate> pendingUpdates;
+};
+}
+
+#endif // DEVICEPROPERTIES_H
@@ -1,2 +1,2 @@
 #include "../libopenrazer.h"
-#include "../razercapability.h"
+#include "../effects.h"
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "libopenrazer.h"
+
+namespace libopenrazer
+{
+
+// Call thunks, one per effect
+static bool breathSingle(Device *d, const EffectParams &p) { return d->setBreathSingle(p.colors[0]); }
+static bool breathDual(Device *d, const EffectParams &p) { return d->setBreathDual(p.colors[0], p.colors[1]); }
+static bool breathTriple(Device *d, const EffectParams &p) { return d->setBreathTriple(p.colors[0], p.colors[1], p.colors[2]); }
+static bool breathRandom(Device *d, const EffectParams &) { return d->setBreathRandom(); }
+static bool wave(Device *d, const EffectParams &p) { return d->setWave(p.direction); }
+static bool reactive(Device *d, const EffectParams &p) { return d->setReactive(p.colors[0], REACTIVE_500MS); } // TODO Configure speed?
+static bool none(Device *d, const EffectParams &) { return d->setNone(); }
+static bool spectrum(Device *d, const EffectParams &) { return d->setSpectrum(); }
+static bool staticColor(Device *d, const EffectParams &p) { return d->setStatic(p.colors[0]); }
+static bool ripple(Device *d, const EffectParams &p) { return d->setRipple(p.colors[0], RIPPLE_REFRESH_RATE); } // TODO Configure refreshrate?
+static bool rippleRandom(Device *d, const EffectParams &) { return d->setRippleRandomColor(RIPPLE_REFRESH_RATE); } // TODO Configure refreshrate?
+static bool pulsate(Device *d, const EffectParams &) { return d->setPulsate(); }
+static bool staticBw2013(Device *d, const EffectParams &) { return d->setStatic_bw2013(); }
+
+static bool logoBlinking(Device *d, const EffectParams &p) { return d->setLogoBlinking(p.colors[0]); }
+static bool logoPulsate(Device *d, const EffectParams &p) { return d->setLogoPulsate(p.colors[0]); }
+static bool logoSpectrum(Device *d, const EffectParams &) { return d->setLogoSpectrum(); }
+static bool logoStatic(Device *d, const EffectParams &p) { return d->setLogoStatic(p.colors[0]); }
+static bool logoNone(Device *d, const EffectParams &) { return d->setLogoNone(); }
+static bool logoReactive(Device *d, const EffectParams &p) { return d->setLogoReactive(p.colors[0], REACTIVE_500MS); }
+static bool logoBreathSingle(Device *d, const EffectParams &p) { return d->setLogoBreathSingle(p.colors[0]); }
+static bool logoBreathDual(Device *d, const EffectParams &p) { return d->setLogoBreathDual(p.colors[0], p.colors[1]); }
+static bool logoBreathRandom(Device *d, const EffectParams &) { return d->setLogoBreathRandom(); }
+
+static bool scrollBlinking(Device *d, const EffectParams &p) { return d->setScrollBlinking(p.colors[0]); }
+static bool scrollPulsate(Device *d, const EffectParams &p) { return d->setScrollPulsate(p.colors[0]); }
+static bool scrollSpectrum(Device *d, const EffectParams &) { return d->setScrollSpectrum(); }
+static bool scrollStatic(Device *d, const EffectParams &p) { return d->setScrollStatic(p.colors[0]); }
+static bool scrollNone(Device *d, const EffectParams &) { return d->setScrollNone(); }
+static bool scrollReactive(Device *d, const EffectParams &p) { return d->setScrollReactive(p.colors[0], REACTIVE_500MS); }
+static bool scrollBreathSingle(Device *d, const EffectParams &p) { return d->setScrollBreathSingle(p.colors[0]); }
+static bool scrollBreathDual(Device *d, const EffectParams &p) { return d->setScrollBreathDual(p.colors[0], p.colors[1]); }
+static bool scrollBreathRandom(Device *d, const EffectParams &) { return d->setScrollBreathRandom(); }
+
+static bool backlightSpectrum(Device *d, const EffectParams &) { return d->setBacklightSpectrum(); }
+static bool backlightStatic(Device *d, const EffectParams &p) { return d->setBacklightStatic(p.colors[0]); }
+
+/*!
+ * \variable libopenrazer::effects
+ *
+ * \brief The lighting effects that can be selected in the UI, in the order they should be listed.
+ *
+ * Every entry has the capability a device needs for the effect, the lighting location it belongs to, how many colors and if a wave direction it takes, and a function applying it to a device.
+ * The table is a constant, so it isn't constructed at startup. Refer to an effect by its index, e.g. as the item data of a combobox, and call \c {effects[index].apply(device, params)}.
+ */
+constexpr Effect effects[] = {
+    { "lighting_breath_single", CAP_LIGHTING_BREATH_SINGLE, Device::Lighting, "Breath Single", 1, false, breathSingle },
+    { "lighting_breath_dual", CAP_LIGHTING_BREATH_DUAL, Device::Lighting, "Breath Dual", 2, false, breathDual },
+    { "lighting_breath_triple", CAP_LIGHTING_BREATH_TRIPLE, Device::Lighting, "Breath Triple", 3, false, breathTriple },
+    { "lighting_breath_random", CAP_LIGHTING_BREATH_RANDOM, Device::Lighting, "Breath Random", 0, false, breathRandom },
+    { "lighting_wave", CAP_LIGHTING_WAVE, Device::Lighting, "Wave", 0, true, wave },
+    { "lighting_reactive", CAP_LIGHTING_REACTIVE, Device::Lighting, "Reactive", 1, false, reactive },
+    { "lighting_none", CAP_LIGHTING_NONE, Device::Lighting, "None", 0, false, none },
+    { "lighting_spectrum", CAP_LIGHTING_SPECTRUM, Device::Lighting, "Spectrum", 0, false, spectrum },
+    { "lighting_static", CAP_LIGHTING_STATIC, Device::Lighting, "Static", 1, false, staticColor },
+    { "lighting_ripple", CAP_LIGHTING_RIPPLE, Device::Lighting, "Ripple", 1, false, ripple }, // Needs "refresh_rate"
+    { "lighting_ripple_random", CAP_LIGHTING_RIPPLE_RANDOM, Device::Lighting, "Ripple random", 0, false, rippleRandom }, // Needs "refresh_rate"
+    { "lighting_pulsate", CAP_LIGHTING_PULSATE, Device::Lighting, "Pulsate", 0, false, pulsate },
+    { "lighting_static_bw2013", CAP_LIGHTING_STATIC_BW2013, Device::Lighting, "Static", 0, false, staticBw2013 },
+
+    { "lighting_logo_blinking", CAP_LIGHTING_LOGO_BLINKING, Device::LightingLogo, "Blinking", 1, false, logoBlinking },
+    { "lighting_logo_pulsate", CAP_LIGHTING_LOGO_PULSATE, Device::LightingLogo, "Pulsate", 1, false, logoPulsate },
+    { "lighting_logo_spectrum", CAP_LIGHTING_LOGO_SPECTRUM, Device::LightingLogo, "Spectrum", 0, false, logoSpectrum },
+    { "lighting_logo_static", CAP_LIGHTING_LOGO_STATIC, Device::LightingLogo, "Static", 1, false, logoStatic },
+    { "lighting_logo_none", CAP_LIGHTING_LOGO_NONE, Device::LightingLogo, "None", 0, false, logoNone },
+    { "lighting_logo_reactive", CAP_LIGHTING_LOGO_REACTIVE, Device::LightingLogo, "Reactive", 1, false, logoReactive },
+    { "lighting_logo_breath_single", CAP_LIGHTING_LOGO_BREATH_SINGLE, Device::LightingLogo, "Breath Single", 1, false, logoBreathSingle },
+    { "lighting_logo_breath_dual", CAP_LIGHTING_LOGO_BREATH_DUAL, Device::LightingLogo, "Breath Dual", 2, false, logoBreathDual },
+    { "lighting_logo_breath_random", CAP_LIGHTING_LOGO_BREATH_RANDOM, Device::LightingLogo, "Breath random", 0, false, logoBreathRandom },
+
+    { "lighting_scroll_blinking", CAP_LIGHTING_SCROLL_BLINKING, Device::LightingScroll, "Blinking", 1, false, scrollBlinking },
+    { "lighting_scroll_pulsate", CAP_LIGHTING_SCROLL_PULSATE, Device::LightingScroll, "Pulsate", 1, false, scrollPulsate },
+    { "lighting_scroll_spectrum", CAP_LIGHTING_SCROLL_SPECTRUM, Device::LightingScroll, "Spectrum", 0, false, scrollSpectrum },
+    { "lighting_scroll_static", CAP_LIGHTING_SCROLL_STATIC, Device::LightingScroll, "Static", 1, false, scrollStatic },
+    { "lighting_scroll_none", CAP_LIGHTING_SCROLL_NONE, Device::LightingScroll, "None", 0, false, scrollNone },
+    { "lighting_scroll_reactive", CAP_LIGHTING_SCROLL_REACTIVE, Device::LightingScroll, "Reactive", 1, false, scrollReactive },
+    { "lighting_scroll_breath_single", CAP_LIGHTING_SCROLL_BREATH_SINGLE, Device::LightingScroll, "Breath Single", 1, false, scrollBreathSingle },
+    { "lighting_scroll_breath_dual", CAP_LIGHTING_SCROLL_BREATH_DUAL, Device::LightingScroll, "Breath Dual", 2, false, scrollBreathDual },
+    { "lighting_scroll_breath_random", CAP_LIGHTING_SCROLL_BREATH_RANDOM, Device::LightingScroll, "Breath random", 0, false, scrollBreathRandom },
+
+    { "lighting_backlight_spectrum", CAP_LIGHTING_BACKLIGHT_SPECTRUM, Device::LightingBacklight, "Spectrum", 0, false, backlightSpectrum },
+    { "lighting_backlight_static", CAP_LIGHTING_BACKLIGHT_STATIC, Device::LightingBacklight, "Static", 1, false, backlightStatic },
+};
+
+/*!
+ * \variable libopenrazer::effectCount
+ *
+ * \brief The number of entries in libopenrazer::effects.
+ */
+constexpr int effectCount = sizeof(effects) / sizeof(effects[0]);
+
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <QColor>
+
+namespace libopenrazer
+{
+class Device;
+
+// Arguments for an effect, only the ones the effect uses are read
+struct EffectParams {
+    QColor colors[3];
+    WaveDirection direction;
+};
+
+struct Effect {
+    // Capability name from the pylib, e.g. "lighting_logo_spectrum"
+    const char *identifier;
+    Capability capability;
+    Device::LightingLocation location;
+    // Human readable name for the UI
+    const char *displayString;
+    int numColors;
+    bool wave;
+    bool (*apply)(Device *device, const EffectParams &params);
+};
+
+extern const Effect effects[];
+extern const int effectCount;
+}
+
+#endif // EFFECTS_H
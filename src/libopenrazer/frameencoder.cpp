@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstring>
+
+// The SSSE3 kernel is compiled for x86 whatever the build flags are and picked at runtime
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_SSSE3_KERNEL
+#include <tmmintrin.h>
+#endif
+
+#include "frameencoder.h"
+
+namespace libopenrazer
+{
+
+/**
+ * Copies \a count RGBA pixels from \a src to \a dst as RGB, dropping the alpha channel.
+ */
+static void copyRgbaToRgbScalar(uchar *dst, const uchar *src, int count)
+{
+    for(int i = 0; i < count; i++) {
+        dst[i*3] = src[i*4];
+        dst[i*3+1] = src[i*4+1];
+        dst[i*3+2] = src[i*4+2];
+    }
+}
+
+#ifdef HAVE_SSSE3_KERNEL
+/**
+ * Same as copyRgbaToRgbScalar(), for CPUs with SSSE3.
+ */
+__attribute__((target("ssse3")))
+static void copyRgbaToRgbSsse3(uchar *dst, const uchar *src, int count)
+{
+    int i = 0;
+    // Moves 4 pixels per iteration. The 16 byte store writes 4 bytes more than the 12 used ones,
+    // so only use it while there are at least 2 more pixels behind the current 4 to absorb them.
+    const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for(; i + 6 <= count; i += 4) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*3), _mm_shuffle_epi8(in, mask));
+    }
+    copyRgbaToRgbScalar(dst + i*3, src + i*4, count - i);
+}
+#endif
+
+typedef void (*CopyRgbaToRgb)(uchar *dst, const uchar *src, int count);
+
+/**
+ * Returns the fastest copyRgbaToRgb...() the CPU supports.
+ */
+static CopyRgbaToRgb selectCopyRgbaToRgb()
+{
+#ifdef HAVE_SSSE3_KERNEL
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("ssse3")) {
+        return copyRgbaToRgbSsse3;
+    }
+#endif
+    return copyRgbaToRgbScalar;
+}
+
+/**
+ * Copies \a count RGBA pixels from \a src to \a dst as RGB, dropping the alpha channel.
+ */
+static void copyRgbaToRgb(uchar *dst, const uchar *src, int count)
+{
+    // Picked once, the initialization of a local static is thread-safe
+    static const CopyRgbaToRgb copy = selectCopyRgbaToRgb();
+    copy(dst, src, count);
+}
+
+/*!
+ * \class libopenrazer::FrameEncoder
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::FrameEncoder class encodes a frame from a contiguous pixel buffer into the payload format of the \c setKeyRow D-Bus method.
+ *
+ * The payload buffers are allocated once in resize() and reused for every frame afterwards, so encoding a frame doesn't allocate memory.
+ * A payload passed to a \c QDBusMessage stays shared with it until its call finished, so the encoder keeps a ring of bufferCount() buffers and only reuses a buffer nobody else holds anymore.
+ * As long as no more than bufferCount() - 1 encoded payloads are in flight, encoding never has to allocate.
+ * Converting RGBA input uses SSSE3 on x86 CPUs supporting it, chosen at runtime.
+ *
+ * The encoder also remembers the last frame it encoded. encodeChanged() compares against it and only puts the rows that changed into the payload.
+ */
+
+/*!
+ * \fn libopenrazer::FrameEncoder::FrameEncoder()
+ *
+ * Constructs an encoder for an empty matrix. Call resize() before encoding.
+ */
+FrameEncoder::FrameEncoder() : mRows(0), mColumns(0), mEncodedRows(0), mCommittedValid(false), mBuffers(2), mCurrent(0)
+{
+}
+
+/*!
+ * \fn libopenrazer::FrameEncoder::FrameEncoder(int rows, int columns)
+ *
+ * Constructs an encoder for a matrix with the given number of \a rows and \a columns.
+ */
+FrameEncoder::FrameEncoder(int rows, int columns) : mRows(0), mColumns(0), mEncodedRows(0), mCommittedValid(false), mBuffers(2), mCurrent(0)
+{
+    resize(rows, columns);
+}
+
+FrameEncoder::~FrameEncoder()
+{
+}
+
+/*!
+ * \fn void libopenrazer::FrameEncoder::resize(int rows, int columns)
+ *
+ * Sets the matrix dimensions to \a rows and \a columns and preallocates the payload buffer.
+ * Changing the dimensions invalidates the remembered frame.
+ */
+void FrameEncoder::resize(int rows, int columns)
+{
+    if(rows == mRows && columns == mColumns) {
+        return;
+    }
+    mRows = rows;
+    mColumns = columns;
+    mEncodedRows = 0;
+    mCommittedValid = false;
+    // Reserve the capacity so shrinking the payload for partial frames keeps the memory
+    for(int i=0; i<mBuffers.size(); i++) {
+        mBuffers[i] = QByteArray();
+        mBuffers[i].reserve(rows * (3 + columns*3));
+    }
+    mCommitted.resize(rows * columns * 3);
+}
+
+/*!
+ * \fn void libopenrazer::FrameEncoder::setBufferCount(int count)
+ *
+ * Sets the number of payload buffers to \a count, at least 2. Keep it one higher than the number of payloads that can be in flight at the same time.
+ */
+void FrameEncoder::setBufferCount(int count)
+{
+    count = qMax(2, count);
+    int oldCount = mBuffers.size();
+    if(count == oldCount) {
+        return;
+    }
+    // Only the new buffers need their memory, the payload of the last frame stays where it is
+    QByteArray current = mBuffers[mCurrent];
+    mBuffers.resize(count);
+    for(int i=oldCount; i<count; i++) {
+        mBuffers[i].reserve(mRows * (3 + mColumns*3));
+    }
+    if(mCurrent >= count) {
+        mCurrent = 0;
+        mBuffers[0] = current;
+    }
+}
+
+/*!
+ * \fn int libopenrazer::FrameEncoder::bufferCount() const
+ *
+ * Returns the number of payload buffers.
+ */
+int FrameEncoder::bufferCount() const
+{
+    return mBuffers.size();
+}
+
+/*!
+ * \fn int libopenrazer::FrameEncoder::rows() const
+ *
+ * Returns the number of rows of the matrix.
+ */
+int FrameEncoder::rows() const
+{
+    return mRows;
+}
+
+/*!
+ * \fn int libopenrazer::FrameEncoder::columns() const
+ *
+ * Returns the number of columns of the matrix.
+ */
+int FrameEncoder::columns() const
+{
+    return mColumns;
+}
+
+/*!
+ * \fn const QByteArray &libopenrazer::FrameEncoder::encode(const uchar *pixels, PixelFormat format)
+ *
+ * Encodes the frame in \a pixels, which has to contain rows() * columns() pixels in the given \a format, row after row.
+ *
+ * Returns the payload, containing \c {[row, startcol, endcol, r, g, b, ...]} for every row.
+ *
+ * \sa encodeChanged()
+ */
+const QByteArray &FrameEncoder::encode(const uchar *pixels, PixelFormat format)
+{
+    return encodeRows(pixels, format, false);
+}
+
+/*!
+ * \fn const QByteArray &libopenrazer::FrameEncoder::encodeChanged(const uchar *pixels, PixelFormat format)
+ *
+ * Like encode(), but only rows that differ from the previously encoded frame are put into the payload.
+ * If nothing changed, the returned payload is empty. Every row is encoded if there is no previous frame, see invalidate().
+ *
+ * \sa encodedRows()
+ */
+const QByteArray &FrameEncoder::encodeChanged(const uchar *pixels, PixelFormat format)
+{
+    return encodeRows(pixels, format, true);
+}
+
+/**
+ * Encodes all rows (or only the changed ones if \a onlyChanged is set) and remembers the frame.
+ */
+const QByteArray &FrameEncoder::encodeRows(const uchar *pixels, PixelFormat format, bool onlyChanged)
+{
+    mEncodedRows = 0;
+    QByteArray &payload = nextBuffer();
+    if(mRows == 0 || mColumns == 0) {
+        payload.resize(0);
+        return payload;
+    }
+
+    const int rowSize = mColumns*3;
+    const int inRowSize = mColumns * bytesPerPixel(format);
+    const bool compare = onlyChanged && mCommittedValid;
+
+    // Doesn't reallocate as the full size is reserved
+    payload.resize(mRows * (3 + rowSize));
+    uchar *begin = reinterpret_cast<uchar*>(payload.data());
+    uchar *out = begin;
+    uchar *committed = reinterpret_cast<uchar*>(mCommitted.data());
+    for(int row=0; row<mRows; row++) {
+        const uchar *in = pixels + row*inRowSize;
+        uchar *committedRow = committed + row*rowSize;
+        uchar *rgb = out + 3;
+        if(format == RGB888) {
+            if(compare && memcmp(in, committedRow, rowSize) == 0) {
+                continue;
+            }
+            memcpy(rgb, in, rowSize);
+        } else {
+            copyRgbaToRgb(rgb, in, mColumns);
+            // The next row gets written to the same position if this one is unchanged
+            if(compare && memcmp(rgb, committedRow, rowSize) == 0) {
+                continue;
+            }
+        }
+        memcpy(committedRow, rgb, rowSize);
+        out[0] = row;
+        out[1] = 0;
+        out[2] = mColumns - 1;
+        out += 3 + rowSize;
+        mEncodedRows++;
+    }
+    mCommittedValid = true;
+    payload.resize(out - begin);
+    return payload;
+}
+
+/**
+ * Returns the buffer to encode the next frame into, the first one after the current that isn't shared anymore.
+ * If all are still shared, the next one gets detached by writing to it.
+ */
+QByteArray &FrameEncoder::nextBuffer()
+{
+    for(int i=1; i<=mBuffers.size(); i++) {
+        int index = (mCurrent + i) % mBuffers.size();
+        if(mBuffers[index].isDetached()) {
+            mCurrent = index;
+            return mBuffers[index];
+        }
+    }
+    mCurrent = (mCurrent + 1) % mBuffers.size();
+    return mBuffers[mCurrent];
+}
+
+/*!
+ * \fn const QByteArray &libopenrazer::FrameEncoder::payload() const
+ *
+ * Returns the payload of the last encoded frame.
+ */
+const QByteArray &FrameEncoder::payload() const
+{
+    return mBuffers[mCurrent];
+}
+
+/*!
+ * \fn int libopenrazer::FrameEncoder::encodedRows() const
+ *
+ * Returns the number of rows in the payload of the last encoded frame.
+ */
+int FrameEncoder::encodedRows() const
+{
+    return mEncodedRows;
+}
+
+/*!
+ * \fn void libopenrazer::FrameEncoder::invalidate()
+ *
+ * Forgets the previously encoded frame, so the next call to encodeChanged() encodes every row.
+ */
+void FrameEncoder::invalidate()
+{
+    mCommittedValid = false;
+}
+
+/*!
+ * \fn int libopenrazer::FrameEncoder::bytesPerPixel(PixelFormat format)
+ *
+ * Returns the number of bytes one pixel in the given \a format takes.
+ */
+int FrameEncoder::bytesPerPixel(PixelFormat format)
+{
+    return format == RGBA8888 ? 4 : 3;
+}
+
+}
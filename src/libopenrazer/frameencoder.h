@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FRAMEENCODER_H
+#define FRAMEENCODER_H
+
+#include <QByteArray>
+#include <QVector>
+
+namespace libopenrazer
+{
+class FrameEncoder
+{
+public:
+    enum PixelFormat { RGB888, RGBA8888 };
+
+    FrameEncoder();
+    FrameEncoder(int rows, int columns);
+    ~FrameEncoder();
+
+    void resize(int rows, int columns);
+    int rows() const;
+    int columns() const;
+
+    void setBufferCount(int count);
+    int bufferCount() const;
+
+    const QByteArray &encode(const uchar *pixels, PixelFormat format);
+    const QByteArray &encodeChanged(const uchar *pixels, PixelFormat format);
+    const QByteArray &payload() const;
+    int encodedRows() const;
+    void invalidate();
+
+    static int bytesPerPixel(PixelFormat format);
+private:
+    const QByteArray &encodeRows(const uchar *pixels, PixelFormat format, bool onlyChanged);
+    QByteArray &nextBuffer();
+
+    int mRows;
+    int mColumns;
+    int mEncodedRows;
+    bool mCommittedValid;
+    QVector<QByteArray> mBuffers;
+    int mCurrent;
+    QByteArray mCommitted;
+};
+}
+
+#endif // FRAMEENCODER_H
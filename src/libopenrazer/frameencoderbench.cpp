@@ -0,0 +1,93 @@
+#include "frameencoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Counts heap allocations by wrapping the allocator of glibc. Only the measured loop is counted.
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+static bool counting = false;
+static unsigned long allocations = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    if(counting)
+        allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    if(counting)
+        allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if(counting)
+        allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+// Checks that RGBA input, converted by the SSSE3 or the scalar code depending on the CPU, encodes like the same frame as RGB
+static bool rgbaMatchesRgb(int rows, int columns)
+{
+    std::vector<uchar> rgb(rows * columns * 3);
+    std::vector<uchar> rgba(rows * columns * 4);
+    for(int i=0; i<rows*columns; i++) {
+        for(int c=0; c<3; c++) {
+            rgb[i*3+c] = rgba[i*4+c] = i*7 + c;
+        }
+        rgba[i*4+3] = 0xff;
+    }
+    libopenrazer::FrameEncoder rgbEncoder(rows, columns);
+    libopenrazer::FrameEncoder rgbaEncoder(rows, columns);
+    return rgbEncoder.encode(rgb.data(), libopenrazer::FrameEncoder::RGB888) == rgbaEncoder.encode(rgba.data(), libopenrazer::FrameEncoder::RGBA8888);
+}
+
+// Encodes frames while the payloads of the last frames are still held, like messages waiting for their reply.
+// Usage: frameencoderbench [frames] [window]
+int main(int argc, char *argv[])
+{
+    const int frames = argc > 1 ? atoi(argv[1]) : 100000;
+    const int window = argc > 2 ? atoi(argv[2]) : 2;
+    const int rows = 6;
+    const int columns = 22;
+    const int maxWindow = 16;
+    if(frames < 1 || window < 1 || window > maxWindow) {
+        fprintf(stderr, "Usage: %s [frames] [window (1-%d)]\n", argv[0], maxWindow);
+        return 2;
+    }
+
+    const libopenrazer::FrameEncoder::PixelFormat formats[] = { libopenrazer::FrameEncoder::RGB888, libopenrazer::FrameEncoder::RGBA8888 };
+    const char *formatNames[] = { "RGB888", "RGBA8888" };
+    int result = 0;
+    if(!rgbaMatchesRgb(rows, columns)) {
+        printf("RGBA8888 input encodes differently than RGB888\n");
+        result = 1;
+    }
+    for(int f=0; f<2; f++) {
+        libopenrazer::FrameEncoder encoder(rows, columns);
+        encoder.setBufferCount(window + 1);
+        std::vector<uchar> pixels(rows * columns * libopenrazer::FrameEncoder::bytesPerPixel(formats[f]));
+        QByteArray inFlight[maxWindow];
+
+        allocations = 0;
+        counting = true;
+        for(int i=0; i<frames; i++) {
+            // Change one row per frame, so every payload is sent
+            pixels[(i % rows) * columns * libopenrazer::FrameEncoder::bytesPerPixel(formats[f])] = i;
+            inFlight[i % window] = encoder.encodeChanged(pixels.data(), formats[f]);
+        }
+        counting = false;
+
+        printf("%s: %lu allocations in %d frames with %d frames in flight\n", formatNames[f], allocations, frames, window);
+        if(allocations != 0)
+            result = 1;
+    }
+    return result;
+}
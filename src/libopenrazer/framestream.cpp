@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+
+#include <cstring>
+
+#include "framestream.h"
+#include "iothread.h"
+
+namespace libopenrazer
+{
+
+/*!
+ * \class libopenrazer::FrameStream
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::FrameStream class streams matrix frames to a device with a bounded number of frames in flight.
+ *
+ * Every frame is encoded with Device::setMatrixFrameAsync() and its calls are queued as StreamingCall, see queueCall(). At most window() frames are sent without the daemon having acknowledged them.
+ * While the window is full, a new frame replaces the frame waiting to be sent, the replaced frame is counted as dropped.
+ * As the device only sends the rows that changed since the last sent frame, rows changed by a dropped frame are still sent with the frame replacing it.
+ * That way a producer that is faster than the device can't build up a backlog in the daemon and the lighting doesn't lag behind.
+ *
+ * The device has to outlive the stream.
+ */
+
+/*!
+ * \fn libopenrazer::FrameStream::FrameStream(Device *device, int window, QObject *parent)
+ *
+ * Constructs a stream sending frames to \a device, with at most \a window unacknowledged frames.
+ */
+FrameStream::FrameStream(Device *device, int window, QObject *parent) : QObject(parent), device(device), mWindow(qMax(1, window)), inFlight(0),
+    mHasPendingFrame(false), pendingRows(0), pendingColumns(0), pendingFormat(FrameEncoder::RGB888),
+    mLastAckLatency(0), mAverageAckLatency(0), mSentFrames(0), mDroppedFrames(0)
+{
+    device->setMatrixFrameWindow(mWindow);
+    clock.start();
+}
+
+FrameStream::~FrameStream()
+{
+}
+
+/*!
+ * \fn void libopenrazer::FrameStream::setWindow(int window)
+ *
+ * Sets the maximum number of unacknowledged frames to \a window, at least 1.
+ */
+void FrameStream::setWindow(int window)
+{
+    mWindow = qMax(1, window);
+    device->setMatrixFrameWindow(mWindow);
+}
+
+/*!
+ * \fn int libopenrazer::FrameStream::window() const
+ *
+ * Returns the maximum number of unacknowledged frames.
+ */
+int FrameStream::window() const
+{
+    return mWindow;
+}
+
+/*!
+ * \fn void libopenrazer::FrameStream::pushFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format)
+ *
+ * Queues the frame in \a pixels, see Device::setMatrixFrame() for the meaning of \a rows, \a columns and \a format.
+ * The frame is sent right away if the window isn't full, otherwise it is copied and sent once a frame in flight got acknowledged.
+ */
+void FrameStream::pushFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format)
+{
+    if(inFlight < mWindow) {
+        sendFrame(pixels, rows, columns, format);
+        return;
+    }
+
+    if(mHasPendingFrame) {
+        mDroppedFrames++;
+    }
+    // Doesn't reallocate as long as the frame size stays the same
+    int size = rows * columns * FrameEncoder::bytesPerPixel(format);
+    pendingPixels.resize(size);
+    memcpy(pendingPixels.data(), pixels, size);
+    pendingRows = rows;
+    pendingColumns = columns;
+    pendingFormat = format;
+    mHasPendingFrame = true;
+}
+
+/**
+ * Sends the frame and keeps track of the reply if one is expected.
+ */
+void FrameStream::sendFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format)
+{
+    CapturedCalls capture;
+    PendingReply<bool> reply = device->setMatrixFrameAsync(pixels, rows, columns, format);
+    QList<QDBusMessage> messages = capture.finish();
+    QList<CallCallback> handlers = capture.replyHandlers();
+    mSentFrames++;
+    if(messages.isEmpty()) {
+        // Unchanged frames aren't sent to the daemon
+        if(reply.isError()) {
+            emit frameFailed(reply.error());
+        }
+        return;
+    }
+
+    // The daemon only answers the last call after the ones before. Their handlers make the device send the next frame completely if they fail.
+    qint64 sentAt = clock.elapsed();
+    for(int i=0; i<messages.size()-1; i++) {
+        CallCallback handler = handlers[i];
+        queueCall(messages[i], StreamingCall, this, [this, handler](const QDBusMessage &reply) {
+            if(handler) {
+                handler(reply);
+            }
+            if(reply.type() == QDBusMessage::ErrorMessage) {
+                failedReply = reply;
+            }
+        });
+    }
+    CallCallback handler = handlers.last();
+    queueCall(messages.last(), StreamingCall, this, [this, handler, sentAt](const QDBusMessage &reply) {
+        if(handler) {
+            handler(reply);
+        }
+        frameFinished(sentAt, reply);
+    });
+    inFlight++;
+}
+
+/**
+ * Updates the statistics and sends the frame held back in the meantime.
+ */
+void FrameStream::frameFinished(qint64 sentAt, const QDBusMessage &reply)
+{
+    inFlight--;
+
+    // A frame also failed if one of the calls before the last one did
+    QDBusMessage result = reply;
+    if(failedReply.type() == QDBusMessage::ErrorMessage) {
+        result = failedReply;
+        failedReply = QDBusMessage();
+    }
+
+    if(result.type() == QDBusMessage::ErrorMessage) {
+        QDBusError error(result);
+        qWarning() << "libopenrazer: Sending frame failed:" << error.message();
+        emit frameFailed(error);
+    } else {
+        mLastAckLatency = clock.elapsed() - sentAt;
+        // Smoothed like the round trip time in TCP
+        if(mAverageAckLatency == 0) {
+            mAverageAckLatency = mLastAckLatency;
+        } else {
+            mAverageAckLatency += (mLastAckLatency - mAverageAckLatency) / 8;
+        }
+        emit frameAcknowledged(mLastAckLatency);
+    }
+
+    if(mHasPendingFrame) {
+        mHasPendingFrame = false;
+        sendFrame(reinterpret_cast<const uchar*>(pendingPixels.constData()), pendingRows, pendingColumns, pendingFormat);
+    }
+}
+
+/*!
+ * \fn int libopenrazer::FrameStream::queueDepth() const
+ *
+ * Returns the number of frames sent but not acknowledged yet.
+ */
+int FrameStream::queueDepth() const
+{
+    return inFlight;
+}
+
+/*!
+ * \fn bool libopenrazer::FrameStream::hasPendingFrame() const
+ *
+ * Returns if a frame is waiting for the window to have room.
+ */
+bool FrameStream::hasPendingFrame() const
+{
+    return mHasPendingFrame;
+}
+
+/*!
+ * \fn qint64 libopenrazer::FrameStream::lastAckLatency() const
+ *
+ * Returns the time in milliseconds between sending the last acknowledged frame and its acknowledgement.
+ */
+qint64 FrameStream::lastAckLatency() const
+{
+    return mLastAckLatency;
+}
+
+/*!
+ * \fn double libopenrazer::FrameStream::averageAckLatency() const
+ *
+ * Returns the smoothed acknowledgement latency in milliseconds.
+ */
+double FrameStream::averageAckLatency() const
+{
+    return mAverageAckLatency;
+}
+
+/*!
+ * \fn quint64 libopenrazer::FrameStream::sentFrames() const
+ *
+ * Returns the number of frames passed to the device.
+ */
+quint64 FrameStream::sentFrames() const
+{
+    return mSentFrames;
+}
+
+/*!
+ * \fn quint64 libopenrazer::FrameStream::droppedFrames() const
+ *
+ * Returns the number of frames replaced by a newer frame before they could be sent.
+ */
+quint64 FrameStream::droppedFrames() const
+{
+    return mDroppedFrames;
+}
+
+/*!
+ * \fn void libopenrazer::FrameStream::frameAcknowledged(qint64 latency)
+ *
+ * This signal is emitted when the daemon acknowledged a frame, \a latency milliseconds after it was sent.
+ */
+
+/*!
+ * \fn void libopenrazer::FrameStream::frameFailed(const QDBusError &error)
+ *
+ * This signal is emitted when sending a frame failed with \a error.
+ */
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FRAMESTREAM_H
+#define FRAMESTREAM_H
+
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QObject>
+
+#include "libopenrazer.h"
+
+namespace libopenrazer
+{
+class FrameStream : public QObject
+{
+    Q_OBJECT
+public:
+    FrameStream(Device *device, int window = 2, QObject *parent = 0);
+    ~FrameStream();
+
+    void setWindow(int window);
+    int window() const;
+
+    void pushFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format);
+
+    int queueDepth() const;
+    bool hasPendingFrame() const;
+    qint64 lastAckLatency() const;
+    double averageAckLatency() const;
+    quint64 sentFrames() const;
+    quint64 droppedFrames() const;
+signals:
+    void frameAcknowledged(qint64 latency);
+    void frameFailed(const QDBusError &error);
+private:
+    void sendFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format);
+    void frameFinished(qint64 sentAt, const QDBusMessage &reply);
+
+    Device *device;
+    int mWindow;
+    int inFlight;
+    QElapsedTimer clock;
+    QDBusMessage failedReply;
+
+    bool mHasPendingFrame;
+    QByteArray pendingPixels;
+    int pendingRows;
+    int pendingColumns;
+    FrameEncoder::PixelFormat pendingFormat;
+
+    qint64 mLastAckLatency;
+    double mAverageAckLatency;
+    quint64 mSentFrames;
+    quint64 mDroppedFrames;
+};
+}
+
+#endif // FRAMESTREAM_H
@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+
+#include "callpolicy.h"
+#include "iothread.h"
+
+// Name of the private connection owned by the I/O thread
+#define IO_CONNECTION_NAME "libopenrazer-io"
+
+namespace libopenrazer
+{
+
+// Defined in libopenrazer.cpp
+QDBusPendingCall QDBusMessageToPendingCall(const QDBusMessage &message);
+
+/*!
+ * \enum libopenrazer::CallClass
+ *
+ * This enum type specifies the priority class of a call queued with queueCall(), from the most to the least urgent one.
+ *
+ * \value InteractiveCall
+ *        A setting changed by the user, e.g. with a slider. Sent right away, even while calls of the other classes are waiting.
+ * \value StreamingCall
+ *        A frame of a stream, see FrameStream.
+ * \value BackgroundCall
+ *        Polling values nobody is waiting for, e.g. DeviceProperties::refresh().
+ * \omitvalue CallClassCount
+ */
+
+// The daemon handles calls one after another, so every call sent is a call an interactive one may have to wait for
+static const int maxBulkInFlight = 2;
+
+struct QueuedCallback {
+    bool guarded;
+    QPointer<QObject> context;
+    CallCallback callback;
+};
+
+static QMutex ioMutex;
+static QThread *ioThread = NULL;
+static IoWorker *ioWorker = NULL;
+static QObject *ioRelay = NULL;
+static QHash<quint64, QueuedCallback> callbacks;
+static quint64 nextCallId = 0;
+
+/**
+ * Calls the callback of call \a id with its \a reply, in the thread that started the I/O thread.
+ */
+static void deliverReply(quint64 id, const QDBusMessage &reply)
+{
+    QueuedCallback c;
+    {
+        QMutexLocker locker(&ioMutex);
+        if(!callbacks.contains(id)) {
+            return;
+        }
+        c = callbacks.take(id);
+    }
+    // The callback may queue the next call
+    if(!c.guarded || c.context) {
+        c.callback(reply);
+    }
+}
+
+/*!
+ * \fn bool libopenrazer::startIoThread()
+ *
+ * Starts the I/O thread. It owns a private connection to the session bus, which all calls to the daemon are sent over from then on.
+ *
+ * Calls made with queueCall() are held back in a queue per CallClass and sent by the I/O thread, so that an interactive call never waits behind a backlog of frames or polls:
+ * streaming and background calls are only sent while fewer than two of them are waiting for their reply, and only when no call of a more urgent class is waiting to be sent.
+ * Callbacks are called in the thread that started the I/O thread.
+ *
+ * Calls not made with queueCall() are sent over the private connection right away. Synchronous methods still block until their reply arrives, use the \c ...Async() variants to avoid that.
+ *
+ * Returns \c true if the thread is running.
+ */
+bool startIoThread()
+{
+    QMutexLocker locker(&ioMutex);
+    if(ioThread != NULL) {
+        return true;
+    }
+    IoWorker *worker = new IoWorker();
+    if(!worker->connection().isConnected()) {
+        qWarning() << "libopenrazer: Failed to open a private connection to the session bus:" << worker->connection().lastError().message();
+        delete worker;
+        return false;
+    }
+    qRegisterMetaType<QDBusMessage>();
+    ioRelay = new QObject();
+    QObject::connect(worker, &IoWorker::callFinished, ioRelay, &deliverReply, Qt::QueuedConnection);
+
+    ioThread = new QThread();
+    ioThread->setObjectName(IO_CONNECTION_NAME);
+    worker->moveToThread(ioThread);
+    ioThread->start();
+    ioWorker = worker;
+    return true;
+}
+
+/*!
+ * \fn void libopenrazer::stopIoThread()
+ *
+ * Stops the I/O thread. Calls still queued or waiting for their reply are dropped.
+ * Their callbacks get a \c QDBusError::Disconnected error instead, in the thread of their context, so whoever keeps track of calls in flight doesn't wait for them forever.
+ */
+void stopIoThread()
+{
+    QThread *thread;
+    IoWorker *worker;
+    QObject *relay;
+    QHash<quint64, QueuedCallback> dropped;
+    {
+        QMutexLocker locker(&ioMutex);
+        thread = ioThread;
+        worker = ioWorker;
+        relay = ioRelay;
+        ioThread = NULL;
+        ioWorker = NULL;
+        ioRelay = NULL;
+        dropped.swap(callbacks);
+    }
+    if(thread == NULL) {
+        return;
+    }
+    thread->quit();
+    thread->wait();
+    delete worker;
+    delete thread;
+    delete relay;
+
+    QDBusMessage error = QDBusMessage::createError(QDBusError::Disconnected, "The I/O thread was stopped");
+    foreach(const QueuedCallback &c, dropped) {
+        CallCallback callback = c.callback;
+        if(!c.guarded) {
+            callback(error);
+        } else if(c.context) {
+            // Like a reply, not called if the context is destroyed before
+            QTimer::singleShot(0, c.context.data(), [callback, error]() {
+                callback(error);
+            });
+        }
+    }
+}
+
+/*!
+ * \fn bool libopenrazer::isIoThreadRunning()
+ *
+ * Returns if the I/O thread is running.
+ */
+bool isIoThreadRunning()
+{
+    QMutexLocker locker(&ioMutex);
+    return ioWorker != NULL;
+}
+
+/*!
+ * \fn void libopenrazer::queueCall(const QDBusMessage &message, CallClass callClass, QObject *context, const CallCallback &callback)
+ *
+ * Queues \a message in the given \a callClass and calls \a callback with the reply once it arrived, unless \a context has been destroyed by then.
+ * \a context can be \c NULL, the callback is always called then. \a callback gets the error reply if the call failed.
+ *
+ * Without the I/O thread running the call is sent right away.
+ *
+ * \sa startIoThread()
+ */
+void queueCall(const QDBusMessage &message, CallClass callClass, QObject *context, const CallCallback &callback)
+{
+    QMutexLocker locker(&ioMutex);
+    if(ioWorker == NULL) {
+        locker.unlock();
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusMessageToPendingCall(message), context);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, [watcher, callback]() {
+            if(callback) {
+                callback(watcher->reply());
+            }
+            watcher->deleteLater();
+        });
+        return;
+    }
+    quint64 id = nextCallId++;
+    if(callback) {
+        QueuedCallback c = { context != NULL, QPointer<QObject>(context), callback };
+        callbacks.insert(id, c);
+    }
+    ioWorker->enqueue(id, message, callClass);
+}
+
+/*!
+ * \fn int libopenrazer::queuedCallCount(CallClass callClass)
+ *
+ * Returns the number of calls of \a callClass waiting to be sent by the I/O thread.
+ */
+int queuedCallCount(CallClass callClass)
+{
+    QMutexLocker locker(&ioMutex);
+    return ioWorker == NULL ? 0 : ioWorker->queuedCount(callClass);
+}
+
+/**
+ * Returns the connection calls to the daemon are sent over, the private one of the I/O thread while it is running.
+ */
+QDBusConnection daemonConnection()
+{
+    QMutexLocker locker(&ioMutex);
+    return ioWorker == NULL ? QDBusConnection::sessionBus() : ioWorker->connection();
+}
+
+static thread_local CapturedCalls *captureTarget = NULL;
+
+/**
+ * While an instance exists, calls made on the current thread aren't sent but collected, so they can be queued with queueCall() instead.
+ * The calls return an empty successful reply. Pass \a sentRightAway as \c false if the calls might be sent later or not at all.
+ */
+CapturedCalls::CapturedCalls(bool sentRightAway) : previous(captureTarget), capturing(true), sentRightAway(sentRightAway)
+{
+    captureTarget = this;
+}
+
+CapturedCalls::~CapturedCalls()
+{
+    finish();
+}
+
+/**
+ * Collects \a message instead of sending it. \a finished is the function whoever sends the message has to call with its reply, see replyHandlers().
+ */
+void CapturedCalls::append(const QDBusMessage &message, const CallCallback &finished)
+{
+    messages.append(message);
+    handlers.append(finished);
+}
+
+/**
+ * Stops collecting and returns the calls collected so far.
+ */
+QList<QDBusMessage> CapturedCalls::finish()
+{
+    if(capturing) {
+        captureTarget = previous;
+        capturing = false;
+    }
+    return messages;
+}
+
+/**
+ * Returns the reply handlers of the collected calls, in the same order as finish(). Handlers of calls without side effects are empty.
+ */
+QList<CallCallback> CapturedCalls::replyHandlers() const
+{
+    return handlers;
+}
+
+/**
+ * Returns if the collected calls are sent as soon as collecting finished. Calls that keep state about what was sent, like matrix frames, refuse to be collected otherwise.
+ */
+bool CapturedCalls::isSentRightAway() const
+{
+    return sentRightAway;
+}
+
+/**
+ * Returns where calls on the current thread are collected, or NULL if they are sent.
+ */
+CapturedCalls *capturedCalls()
+{
+    return captureTarget;
+}
+
+/**
+ * Opens the private connection. The worker is moved to the I/O thread afterwards.
+ */
+IoWorker::IoWorker() : mConnection(QDBusConnection::connectToBus(QDBusConnection::SessionBus, IO_CONNECTION_NAME)), bulkInFlight(0)
+{
+}
+
+IoWorker::~IoWorker()
+{
+    QDBusConnection::disconnectFromBus(IO_CONNECTION_NAME);
+}
+
+/**
+ * Returns the private connection.
+ */
+QDBusConnection IoWorker::connection() const
+{
+    return mConnection;
+}
+
+/**
+ * Appends a call to its queue and wakes the I/O thread up. Can be called from any thread.
+ */
+void IoWorker::enqueue(quint64 id, const QDBusMessage &message, CallClass callClass)
+{
+    QMutexLocker locker(&mutex);
+    Request r = { id, message, 0 };
+    queues[callClass].enqueue(r);
+    QMetaObject::invokeMethod(this, "dispatch", Qt::QueuedConnection);
+}
+
+/**
+ * Returns the number of calls of \a callClass waiting to be sent.
+ */
+int IoWorker::queuedCount(CallClass callClass) const
+{
+    QMutexLocker locker(&mutex);
+    return queues[callClass].size();
+}
+
+/**
+ * Sends queued calls, the most urgent class first, as long as the limits allow it. Runs in the I/O thread.
+ */
+void IoWorker::dispatch()
+{
+    forever {
+        Request r;
+        CallClass callClass = CallClassCount;
+        {
+            QMutexLocker locker(&mutex);
+            for(int c = InteractiveCall; c < CallClassCount; c++) {
+                if(queues[c].isEmpty()) {
+                    continue;
+                }
+                // Less urgent calls are not allowed to pass a call held back
+                if(c == InteractiveCall || bulkInFlight < maxBulkInFlight) {
+                    callClass = static_cast<CallClass>(c);
+                    r = queues[c].dequeue();
+                }
+                break;
+            }
+        }
+        if(callClass == CallClassCount) {
+            return;
+        }
+
+        if(!allowCall()) {
+            emit callFinished(r.id, circuitOpenCall().reply());
+            continue;
+        }
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(mConnection.asyncCall(r.message, callPolicy().timeout), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &IoWorker::callReplied);
+        Sent s = { r, callClass };
+        inFlight.insert(watcher, s);
+        if(callClass != InteractiveCall) {
+            bulkInFlight++;
+        }
+    }
+}
+
+void IoWorker::callReplied(QDBusPendingCallWatcher *watcher)
+{
+    Sent s = inFlight.take(watcher);
+    watcher->deleteLater();
+    if(s.callClass != InteractiveCall) {
+        bulkInFlight--;
+    }
+    CallError error = toCallError(watcher->error());
+    recordCallResult(error);
+    if(shouldRetry(s.request.message, error, s.request.attempt)) {
+        // Goes first in its queue again once the backoff ran out, the I/O thread keeps sending the others meanwhile
+        Request r = s.request;
+        r.attempt++;
+        CallClass callClass = s.callClass;
+        QTimer::singleShot(retryDelay(s.request.attempt), this, [this, r, callClass]() {
+            {
+                QMutexLocker locker(&mutex);
+                queues[callClass].prepend(r);
+            }
+            dispatch();
+        });
+    } else {
+        emit callFinished(s.request.id, watcher->reply());
+    }
+    dispatch();
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IOTHREAD_H
+#define IOTHREAD_H
+
+#include <functional>
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+
+namespace libopenrazer
+{
+enum CallClass { InteractiveCall, StreamingCall, BackgroundCall, CallClassCount };
+
+typedef std::function<void(const QDBusMessage &reply)> CallCallback;
+
+bool startIoThread();
+void stopIoThread();
+bool isIoThreadRunning();
+void queueCall(const QDBusMessage &message, CallClass callClass, QObject *context, const CallCallback &callback = CallCallback());
+int queuedCallCount(CallClass callClass);
+
+// Internal, used by the call helpers and the queued senders
+QDBusConnection daemonConnection();
+
+class CapturedCalls
+{
+public:
+    CapturedCalls(bool sentRightAway = true);
+    ~CapturedCalls();
+
+    void append(const QDBusMessage &message, const CallCallback &finished = CallCallback());
+    QList<QDBusMessage> finish();
+    QList<CallCallback> replyHandlers() const;
+    bool isSentRightAway() const;
+private:
+    QList<QDBusMessage> messages;
+    QList<CallCallback> handlers;
+    CapturedCalls *previous;
+    bool capturing;
+    bool sentRightAway;
+};
+CapturedCalls *capturedCalls();
+
+class IoWorker : public QObject
+{
+    Q_OBJECT
+public:
+    IoWorker();
+    ~IoWorker();
+
+    QDBusConnection connection() const;
+    void enqueue(quint64 id, const QDBusMessage &message, CallClass callClass);
+    int queuedCount(CallClass callClass) const;
+signals:
+    void callFinished(quint64 id, const QDBusMessage &reply);
+private slots:
+    void dispatch();
+    void callReplied(QDBusPendingCallWatcher *watcher);
+private:
+    struct Request {
+        quint64 id;
+        QDBusMessage message;
+        // Number of retries done so far
+        int attempt;
+    };
+    struct Sent {
+        Request request;
+        CallClass callClass;
+    };
+
+    mutable QMutex mutex;
+    QDBusConnection mConnection;
+    QQueue<Request> queues[CallClassCount];
+    QHash<QDBusPendingCallWatcher*, Sent> inFlight;
+    int bulkInFlight;
+};
+}
+
+Q_DECLARE_METATYPE(libopenrazer::CallCallback)
+
+#endif // IOTHREAD_H
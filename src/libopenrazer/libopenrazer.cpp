@@ -16,21 +16,31 @@
  *
  */
 
+#include <QCoreApplication>
 #include <QDBusMessage>
 #include <QDBusConnection>
 #include <QDebug>
-#include <QDomDocument>
 #include <QFileInfo>
 #include <QDBusArgument>
+#include <QDBusPendingCall>
+#include <QDateTime>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QProcess>
+#include <QMutex>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
 #include <QVariantHash>
+#include <QXmlStreamReader>
 #include <QtGui/qcolor.h>
 
 #include <iostream>
+#include <memory>
 
 #include "libopenrazer.h"
+#include "razerproxies.h"
 
 /*!
     \namespace libopenrazer
@@ -45,10 +55,12 @@ namespace libopenrazer
 
 /**
  * Returns a QDBusMessage object for the given device ("org/razer/serial").
+ * Device methods use the functions generated from dbus/razer.device.xml in razerproxies.h instead. The exceptions are Introspect, which isn't in the XML,
+ * and setDPI, see setDPIAsync().
  */
 QDBusMessage Device::prepareDeviceQDBusMessage(const QString &interface, const QString &method)
 {
-    return QDBusMessage::createMethodCall("org.razer", "/org/razer/device/" + mSerial, interface, method);
+    return QDBusMessage::createMethodCall("org.razer", mObjectPath, interface, method);
 }
 
 /**
@@ -62,7 +74,7 @@ QDBusMessage prepareGeneralQDBusMessage(const QString &interface, const QString
 /**
  * Prints out relevant error information about a failed DBus call.
  */
-void printError(QDBusMessage& message, const char *functionname)
+void printError(const QDBusMessage& message, const char *functionname)
 {
     qWarning() << "libopenrazer: There was an error in" << functionname << "!";
     qWarning() << "libopenrazer:" << message.errorName();
@@ -70,11 +82,10 @@ void printError(QDBusMessage& message, const char *functionname)
 }
 
 /**
- * Sends a QDBusMessage and returns the boolean value.
+ * Extracts the boolean value from a reply.
  */
-bool QDBusMessageToBool(const QDBusMessage &message)
+bool replyToBool(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
         // Everything went fine.
         return msg.arguments()[0].toBool();
@@ -85,11 +96,10 @@ bool QDBusMessageToBool(const QDBusMessage &message)
 }
 
 /**
- * Sends a QDBusMessage and returns the integer value.
+ * Extracts the integer value from a reply.
  */
-int QDBusMessageToInt(const QDBusMessage &message)
+int replyToInt(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
         // Everything went fine.
         return msg.arguments()[0].toInt();
@@ -100,11 +110,10 @@ int QDBusMessageToInt(const QDBusMessage &message)
 }
 
 /**
- * Sends a QDBusMessage and returns the double value.
+ * Extracts the double value from a reply.
  */
-double QDBusMessageToDouble(const QDBusMessage &message)
+double replyToDouble(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
         // Everything went fine.
         return msg.arguments()[0].toDouble();
@@ -115,11 +124,10 @@ double QDBusMessageToDouble(const QDBusMessage &message)
 }
 
 /**
- * Sends a QDBusMessage and returns the string value.
+ * Extracts the string value from a reply.
  */
-QString QDBusMessageToString(const QDBusMessage &message)
+QString replyToString(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
         // Everything went fine.
         return msg.arguments()[0].toString();
@@ -130,11 +138,10 @@ QString QDBusMessageToString(const QDBusMessage &message)
 }
 
 /**
- * Sends a QDBusMessage and returns the string value.
+ * Extracts the byte value from a reply.
  */
-uchar QDBusMessageToByte(const QDBusMessage &message)
+uchar replyToByte(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
         // Everything went fine.
         return msg.arguments()[0].value<uchar>();
@@ -145,26 +152,24 @@ uchar QDBusMessageToByte(const QDBusMessage &message)
 }
 
 /**
- * Sends a QDBusMessage and returns the stringlist value.
+ * Extracts the stringlist value from a reply.
  */
-QStringList QDBusMessageToStringList(const QDBusMessage &message)
+QStringList replyToStringList(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
-        return msg.arguments()[0].toStringList();// VID / PID
+        return msg.arguments()[0].toStringList();
     }
     // TODO: Handle error
     printError(msg, Q_FUNC_INFO);
-    return msg.arguments()[0].toStringList();
+    return QStringList();
 }
 
 /**
- * Sends a QDBusMessage and returns the int array value.
+ * Extracts the int array value from a reply.
  */
-QList<int> QDBusMessageToIntArray(const QDBusMessage &message)
+QList<int> replyToIntArray(const QDBusMessage &msg)
 {
     QList<int> retList;
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
     if(msg.type() == QDBusMessage::ReplyMessage) {
 //         qDebug() << "reply :" << msg; // sth like QDBusMessage(type=MethodReturn, service=":1.1482", signature="ai", contents=([Argument: ai {5426, 67}]) )
 //         qDebug() << "reply arguments : " << msg.arguments();
@@ -185,19 +190,140 @@ QList<int> QDBusMessageToIntArray(const QDBusMessage &message)
 }
 
 /**
- * Sends a QDBusMessage and returns the xml value.
+ * Extracts the JSON object string from a reply and returns it as QVariantHash.
+ */
+QVariantHash replyToJsonHash(const QDBusMessage &msg)
+{
+    QString ret = replyToString(msg);
+    return QJsonDocument::fromJson(ret.toUtf8()).object().toVariantHash();
+}
+
+/**
+ * Extracts the device type from a reply.
+ */
+QString replyToDeviceType(const QDBusMessage &msg)
+{
+    QString devicetype = replyToString(msg);
+    // Fix up devicetype for old versions of the daemon (PR #445 in openrazer/openrazer).
+    // TODO: Remove once the new daemon version was released (and was out for a while).
+    if(devicetype == "firefly") {
+        devicetype = "mousemat";
+    } else if(devicetype == "orbweaver" || devicetype == "tartarus") {
+        devicetype = "keypad";
+    }
+    return devicetype;
+}
+
+/**
+ * Returns if the reply is not an error.
  */
-QDomDocument QDBusMessageToXML(const QDBusMessage &message)
+bool replyToVoid(const QDBusMessage &msg)
 {
-    QDBusMessage msg = QDBusConnection::sessionBus().call(message);
-    QDomDocument doc;
     if(msg.type() == QDBusMessage::ReplyMessage) {
-        doc.setContent(msg.arguments()[0].toString());
-        return doc;
+        return true;
     }
-    // TODO: Handle error
     printError(msg, Q_FUNC_INFO);
-    return doc;
+    return false;
+}
+
+/**
+ * Sends a QDBusMessage without waiting for the reply. All asynchronous calls go through here.
+ */
+QDBusPendingCall QDBusMessageToPendingCall(const QDBusMessage &message)
+{
+    CapturedCalls *captured = capturedCalls();
+    if(captured != NULL) {
+        captured->append(message);
+        return QDBusPendingCall::fromCompletedCall(message.createReply());
+    }
+    if(!allowCall()) {
+        return circuitOpenCall();
+    }
+    return daemonConnection().asyncCall(message, callPolicy().timeout);
+}
+
+/**
+ * Sends a QDBusMessage and waits for the reply, following the call policy. All blocking calls go through here.
+ */
+QDBusMessage QDBusMessageToReply(const QDBusMessage &message)
+{
+    QDBusPendingCall call = QDBusMessageToPendingCall(message);
+    finishPendingCall(message, &call);
+    return call.reply();
+}
+
+/**
+ * Sends a QDBusMessage and returns the boolean value.
+ */
+bool QDBusMessageToBool(const QDBusMessage &message)
+{
+    return replyToBool(QDBusMessageToReply(message));
+}
+
+/**
+ * Sends a QDBusMessage and returns the integer value.
+ */
+int QDBusMessageToInt(const QDBusMessage &message)
+{
+    return replyToInt(QDBusMessageToReply(message));
+}
+
+/**
+ * Sends a QDBusMessage and returns the double value.
+ */
+double QDBusMessageToDouble(const QDBusMessage &message)
+{
+    return replyToDouble(QDBusMessageToReply(message));
+}
+
+/**
+ * Sends a QDBusMessage and returns the string value.
+ */
+QString QDBusMessageToString(const QDBusMessage &message)
+{
+    return replyToString(QDBusMessageToReply(message));
+}
+
+/**
+ * Sends a QDBusMessage and returns the string value.
+ */
+uchar QDBusMessageToByte(const QDBusMessage &message)
+{
+    return replyToByte(QDBusMessageToReply(message));
+}
+
+/**
+ * Sends a QDBusMessage and returns the stringlist value.
+ */
+QStringList QDBusMessageToStringList(const QDBusMessage &message)
+{
+    return replyToStringList(QDBusMessageToReply(message));
+}
+
+/**
+ * Sends a QDBusMessage and returns the int array value.
+ */
+QList<int> QDBusMessageToIntArray(const QDBusMessage &message)
+{
+    return replyToIntArray(QDBusMessageToReply(message));
+}
+
+/**
+ * Returns a shared copy of \a name, so interface and method names are only kept in memory once for all devices.
+ */
+QString internName(const QStringRef &name)
+{
+    static QMutex mutex;
+    static QSet<QString> atoms;
+
+    QString s = name.toString();
+    QMutexLocker locker(&mutex);
+    QSet<QString>::const_iterator it = atoms.constFind(s);
+    if(it != atoms.constEnd()) {
+        return *it;
+    }
+    atoms.insert(s);
+    return s;
 }
 
 /**
@@ -205,10 +331,78 @@ QDomDocument QDBusMessageToXML(const QDBusMessage &message)
  */
 bool QDBusMessageToVoid(const QDBusMessage &message)
 {
-    return QDBusConnection::sessionBus().send(message);
+    if(!allowCall()) {
+        return false;
+    }
+    return daemonConnection().send(message);
     // TODO: Handle error ?
 }
 
+
+/**
+ * Sends a QDBusMessage and returns a pending boolean value.
+ */
+PendingReply<bool> QDBusMessageToBoolAsync(const QDBusMessage &message)
+{
+    return PendingReply<bool>(QDBusMessageToPendingCall(message), replyToBool, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending integer value.
+ */
+PendingReply<int> QDBusMessageToIntAsync(const QDBusMessage &message)
+{
+    return PendingReply<int>(QDBusMessageToPendingCall(message), replyToInt, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending double value.
+ */
+PendingReply<double> QDBusMessageToDoubleAsync(const QDBusMessage &message)
+{
+    return PendingReply<double>(QDBusMessageToPendingCall(message), replyToDouble, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending string value.
+ */
+PendingReply<QString> QDBusMessageToStringAsync(const QDBusMessage &message)
+{
+    return PendingReply<QString>(QDBusMessageToPendingCall(message), replyToString, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending stringlist value.
+ */
+PendingReply<QStringList> QDBusMessageToStringListAsync(const QDBusMessage &message)
+{
+    return PendingReply<QStringList>(QDBusMessageToPendingCall(message), replyToStringList, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending byte value.
+ */
+PendingReply<uchar> QDBusMessageToByteAsync(const QDBusMessage &message)
+{
+    return PendingReply<uchar>(QDBusMessageToPendingCall(message), replyToByte, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending int array value.
+ */
+PendingReply<QList<int>> QDBusMessageToIntArrayAsync(const QDBusMessage &message)
+{
+    return PendingReply<QList<int>>(QDBusMessageToPendingCall(message), replyToIntArray, message);
+}
+
+/**
+ * Sends a QDBusMessage and returns a pending value telling if the call was successful.
+ */
+PendingReply<bool> QDBusMessageToVoidAsync(const QDBusMessage &message)
+{
+    return PendingReply<bool>(QDBusMessageToPendingCall(message), replyToVoid, message);
+}
+
 /*!
  * \fn bool libopenrazer::isDaemonRunning()
  *
@@ -217,7 +411,7 @@ bool QDBusMessageToVoid(const QDBusMessage &message)
 bool isDaemonRunning()
 {
     QDBusMessage m = prepareGeneralQDBusMessage("razer.daemon", "version");
-    QDBusMessage msg = QDBusConnection::sessionBus().call(m);
+    QDBusMessage msg = QDBusMessageToReply(m);
     if(msg.type() == QDBusMessage::ReplyMessage) {
         return true;
     } else {
@@ -225,6 +419,21 @@ bool isDaemonRunning()
     }
 }
 
+/*!
+ * \fn bool libopenrazer::isDaemonRegistered()
+ *
+ * Returns if the daemon's name is registered on the session bus.
+ *
+ * Unlike isDaemonRunning(), only the bus is asked, so this doesn't depend on how fast the daemon responds.
+ */
+bool isDaemonRegistered()
+{
+    QDBusMessage m = QDBusMessage::createMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "NameHasOwner");
+    m << "org.razer";
+    // Not a daemon call, so it doesn't go through the call policy
+    return replyToBool(QDBusConnection::sessionBus().call(m));
+}
+
 /*!
  * \fn QVariantHash libopenrazer::getSupportedDevices()
  *
@@ -239,6 +448,17 @@ QVariantHash getSupportedDevices()
     return QJsonDocument::fromJson(ret.toUtf8()).object().toVariantHash();
 }
 
+/*!
+ * \fn PendingReply<QVariantHash> libopenrazer::getSupportedDevicesAsync()
+ *
+ * Non-blocking variant of getSupportedDevices().
+ */
+PendingReply<QVariantHash> getSupportedDevicesAsync()
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.devices", "supportedDevices");
+    return PendingReply<QVariantHash>(QDBusMessageToPendingCall(m), replyToJsonHash, m);
+}
+
 /*!
  * \fn QStringList libopenrazer::getConnectedDevices()
  *
@@ -252,6 +472,17 @@ QStringList getConnectedDevices()
     return QDBusMessageToStringList(m);
 }
 
+/*!
+ * \fn PendingReply<QStringList> libopenrazer::getConnectedDevicesAsync()
+ *
+ * Non-blocking variant of getConnectedDevices().
+ */
+PendingReply<QStringList> getConnectedDevicesAsync()
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.devices", "getDevices");
+    return QDBusMessageToStringListAsync(m);
+}
+
 /*!
  * \fn bool libopenrazer::syncEffects(bool yes)
  *
@@ -272,6 +503,20 @@ bool syncEffects(bool yes)
     return QDBusMessageToVoid(m);
 }
 
+/*!
+ * \fn PendingReply<bool> libopenrazer::syncEffectsAsync(bool yes)
+ *
+ * Non-blocking variant of syncEffects(), as specified by \a yes.
+ */
+PendingReply<bool> syncEffectsAsync(bool yes)
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.devices", "syncEffects");
+    QList<QVariant> args;
+    args.append(yes);
+    m.setArguments(args);
+    return QDBusMessageToVoidAsync(m);
+}
+
 /*!
  * \fn bool libopenrazer::getSyncEffects()
  *
@@ -285,6 +530,17 @@ bool getSyncEffects()
     return QDBusMessageToBool(m);
 }
 
+/*!
+ * \fn PendingReply<bool> libopenrazer::getSyncEffectsAsync()
+ *
+ * Non-blocking variant of getSyncEffects().
+ */
+PendingReply<bool> getSyncEffectsAsync()
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.devices", "getSyncEffects");
+    return QDBusMessageToBoolAsync(m);
+}
+
 /*!
  * \fn QString libopenrazer::getDaemonVersion()
  *
@@ -296,6 +552,17 @@ QString getDaemonVersion()
     return QDBusMessageToString(m);
 }
 
+/*!
+ * \fn PendingReply<QString> libopenrazer::getDaemonVersionAsync()
+ *
+ * Non-blocking variant of getDaemonVersion().
+ */
+PendingReply<QString> getDaemonVersionAsync()
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.daemon", "version");
+    return QDBusMessageToStringAsync(m);
+}
+
 /*!
  * \fn bool libopenrazer::stopDaemon()
  *
@@ -327,6 +594,20 @@ bool setTurnOffOnScreensaver(bool turnOffOnScreensaver)
     return QDBusMessageToVoid(m);
 }
 
+/*!
+ * \fn PendingReply<bool> libopenrazer::setTurnOffOnScreensaverAsync(bool turnOffOnScreensaver)
+ *
+ * Non-blocking variant of setTurnOffOnScreensaver(), as specified by \a turnOffOnScreensaver.
+ */
+PendingReply<bool> setTurnOffOnScreensaverAsync(bool turnOffOnScreensaver)
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.devices", "enableTurnOffOnScreensaver");
+    QList<QVariant> args;
+    args.append(turnOffOnScreensaver);
+    m.setArguments(args);
+    return QDBusMessageToVoidAsync(m);
+}
+
 /*!
  * \fn bool libopenrazer::getTurnOffOnScreensaver()
  *
@@ -341,87 +622,400 @@ bool getTurnOffOnScreensaver()
 }
 
 /*!
- * \fn DaemonStatus libopenrazer::getDaemonStatus()
+ * \fn PendingReply<bool> libopenrazer::getTurnOffOnScreensaverAsync()
  *
- * Returns status of the daemon, see DaemonStatus.
+ * Non-blocking variant of getTurnOffOnScreensaver().
  */
-DaemonStatus getDaemonStatus()
+PendingReply<bool> getTurnOffOnScreensaverAsync()
+{
+    QDBusMessage m = prepareGeneralQDBusMessage("razer.devices", "getOffOnScreensaver");
+    return QDBusMessageToBoolAsync(m);
+}
+
+// systemd manager of the user session, on the session bus
+#define SYSTEMD_SERVICE "org.freedesktop.systemd1"
+#define SYSTEMD_PATH "/org/freedesktop/systemd1"
+#define SYSTEMD_MANAGER_INTERFACE "org.freedesktop.systemd1.Manager"
+#define DAEMON_UNIT "openrazer-daemon.service"
+// Object path of DAEMON_UNIT, systemd escapes every character except [A-Za-z0-9] as _xx
+#define DAEMON_UNIT_PATH "/org/freedesktop/systemd1/unit/openrazer_2ddaemon_2eservice"
+
+/**
+ * Sends a QDBusMessage to systemd. These calls don't go through the daemon's call policy, so systemd errors don't open the circuit breaker.
+ */
+QDBusPendingCall systemdCall(const QDBusMessage &message)
+{
+    return QDBusConnection::sessionBus().asyncCall(message, callPolicy().timeout);
+}
+
+/**
+ * Returns if the error means that there is no systemd on the session bus, e.g. on non-systemd distros or inside flatpak.
+ */
+bool isSystemdMissing(const QString &errorName)
+{
+    return errorName == "org.freedesktop.DBus.Error.ServiceUnknown"
+           || errorName == "org.freedesktop.DBus.Error.NameHasNoOwner"
+           || errorName == "org.freedesktop.DBus.Error.AccessDenied"
+           || errorName == "org.freedesktop.DBus.Error.NoServer"
+           || errorName == "org.freedesktop.DBus.Error.Disconnected";
+}
+
+/**
+ * Converts the reply of GetUnitFileState to a DaemonStatus.
+ */
+DaemonStatus replyToDaemonStatus(const QDBusMessage &msg)
 {
     // Scenarios to handle:
-    // - Command systemctl doesn't exist (e.g. Alpine or Gentoo) - exit code 255
-    // - Unit wasn't found (i.e. daemon is not installed - or only an old version) - exit code 1
+    // - systemd is not on the session bus (e.g. Alpine, Gentoo or flatpak)
+    // - Unit wasn't found (i.e. daemon is not installed - or only an old version)
     // Daemon can be not installed but enabled -.-
-    QProcess process;
-    process.start("systemctl", QStringList() << "--user" << "is-enabled" << "openrazer-daemon.service");
-    process.waitForFinished();
-    QString output(process.readAllStandardOutput());
-    QString error(process.readAllStandardError());
-    if(output == "enabled\n") return DaemonStatus::Enabled;
-    else if(output == "disabled\n") return DaemonStatus::Disabled;
-    else if(error == "Failed to get unit file state for openrazer-daemon.service: No such file or directory\n") return DaemonStatus::NotInstalled;
-    else if(process.error() == QProcess::FailedToStart) { // check if systemctl could be started - fails on non-systemd distros and flatpak
+    if(msg.type() == QDBusMessage::ReplyMessage) {
+        QString state = msg.arguments()[0].toString();
+        if(state == "enabled") return DaemonStatus::Enabled;
+        else if(state == "disabled") return DaemonStatus::Disabled;
+        qWarning() << "libopenrazer: There was an error checking if the daemon is enabled. Unit state is:" << state;
+        return DaemonStatus::Unknown;
+    }
+    if(msg.errorName() == "org.freedesktop.DBus.Error.FileNotFound" || msg.errorName() == "org.freedesktop.systemd1.NoSuchUnit") {
+        return DaemonStatus::NotInstalled;
+    } else if(isSystemdMissing(msg.errorName())) {
         QFileInfo daemonFile("/usr/bin/openrazer-daemon");
         // if the daemon executable does not exist, show the not_installed message - probably flatpak
         if(!daemonFile.exists()) return DaemonStatus::NotInstalled;
         // otherwise show the NoSystemd message - probably a non-systemd distro
         return DaemonStatus::NoSystemd;
-    } else {
-        qWarning() << "libopenrazer: There was an error checking if the daemon is enabled. Unit state is: " << output << ". Error message:" << error;
-        return DaemonStatus::Unknown;
     }
+    printError(msg, Q_FUNC_INFO);
+    return DaemonStatus::Unknown;
 }
 
-/*!
- * \fn QString libopenrazer::getDaemonStatusOutput()
- *
- * Returns the multiline output of \c {"systemctl --user status openrazer-daemon.service"}.
+/**
+ * Formats the unit properties from the reply of Properties.GetAll like the header of \c {"systemctl status"}.
  */
-QString getDaemonStatusOutput()
+QString replyToDaemonStatusOutput(const QDBusMessage &msg)
 {
-    QProcess process;
-    process.start("systemctl", QStringList() << "--user" << "status" << "openrazer-daemon.service");
-    process.waitForFinished();
-    QString output(process.readAllStandardOutput());
-    QString error(process.readAllStandardError());
-    // TODO Handle systemctl not found
-    // TODO Check if output and error and only display what's filled (to get rid of stray newline)
-    return output + "\n" + error;
+    if(msg.type() != QDBusMessage::ReplyMessage) {
+        if(isSystemdMissing(msg.errorName())) {
+            return "systemd is not available: " + msg.errorMessage();
+        }
+        return msg.errorName() + ": " + msg.errorMessage();
+    }
+    QVariantMap properties = qdbus_cast<QVariantMap>(msg.arguments()[0]);
+    QString output = QString(DAEMON_UNIT) + " - " + properties.value("Description").toString() + "\n";
+    output += "   Loaded: " + properties.value("LoadState").toString();
+    QString fragmentPath = properties.value("FragmentPath").toString();
+    if(!fragmentPath.isEmpty()) {
+        output += " (" + fragmentPath + "; " + properties.value("UnitFileState").toString() + ")";
+    }
+    output += "\n   Active: " + properties.value("ActiveState").toString() + " (" + properties.value("SubState").toString() + ")";
+    // Timestamps are in microseconds since the epoch
+    quint64 since = properties.value("StateChangeTimestamp").toULongLong();
+    if(since != 0) {
+        output += " since " + QDateTime::fromMSecsSinceEpoch(since / 1000).toString();
+    }
+    return output + "\n";
 }
 
 /*!
- * \fn bool libopenrazer::enableDaemon()
+ * \fn DaemonStatus libopenrazer::getDaemonStatus()
  *
- * Enables the systemd unit for the OpenRazer daemon to auto-start when the user logs in. Runs \c {"systemctl --user enable openrazer-daemon.service"}
+ * Returns status of the daemon, see DaemonStatus.
  *
- * Returns if the call was successful.
+ * \sa getDaemonStatusAsync()
  */
-bool enableDaemon()
+DaemonStatus getDaemonStatus()
 {
-    QProcess process;
-    process.start("systemctl", QStringList() << "--user" << "enable" << "openrazer-daemon.service");
-    process.waitForFinished();
-    return process.exitCode() == 0;
+    return getDaemonStatusAsync().value();
 }
 
-// ====== DEVICE CLASS ======
-
 /*!
- * \class libopenrazer::Device
- * \inmodule libopenrazer
+ * \fn PendingReply<DaemonStatus> libopenrazer::getDaemonStatusAsync()
  *
- * \brief The libopenrazer::Device class provides an abstraction for the OpenRazer daemon D-Bus interface for easy interaction from C++ applications.
+ * Asks the systemd user instance for the state of the daemon's unit file without waiting for the reply. Without systemd on the session bus, the status is guessed from the installed files.
+ *
+ * \sa getDaemonStatus()
  */
+PendingReply<DaemonStatus> getDaemonStatusAsync()
+{
+    QDBusMessage m = QDBusMessage::createMethodCall(SYSTEMD_SERVICE, SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "GetUnitFileState");
+    m << DAEMON_UNIT;
+    return PendingReply<DaemonStatus>(systemdCall(m), replyToDaemonStatus);
+}
 
 /*!
- * \fn libopenrazer::Device::Device(QString serial)
+ * \fn QString libopenrazer::getDaemonStatusOutput()
  *
- * Constructs a new device object with the given \a serial.
+ * Returns a multiline description of the daemon's unit, like the first lines of \c {"systemctl --user status openrazer-daemon.service"}.
+ *
+ * \sa getDaemonStatusOutputAsync()
  */
-Device::Device(QString s)
+QString getDaemonStatusOutput()
+{
+    return getDaemonStatusOutputAsync().value();
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::getDaemonStatusOutputAsync()
+ *
+ * Like getDaemonStatusOutput(), but doesn't wait for the reply.
+ */
+PendingReply<QString> getDaemonStatusOutputAsync()
+{
+    QDBusMessage m = QDBusMessage::createMethodCall(SYSTEMD_SERVICE, DAEMON_UNIT_PATH, "org.freedesktop.DBus.Properties", "GetAll");
+    m << "org.freedesktop.systemd1.Unit";
+    return PendingReply<QString>(systemdCall(m), replyToDaemonStatusOutput);
+}
+
+/*!
+ * \fn bool libopenrazer::enableDaemon()
+ *
+ * Enables the systemd unit for the OpenRazer daemon to auto-start when the user logs in, like \c {"systemctl --user enable openrazer-daemon.service"}.
+ *
+ * Returns if the call was successful.
+ *
+ * \sa enableDaemonAsync()
+ */
+bool enableDaemon()
+{
+    return enableDaemonAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::enableDaemonAsync()
+ *
+ * Like enableDaemon(), but doesn't wait for the reply.
+ * systemd is reloaded once enabling the unit succeeded, the reply finishes with the reply to the reload. The reload is sent from the event loop of the calling thread, or when waiting for the reply.
+ */
+PendingReply<bool> enableDaemonAsync()
+{
+    QDBusMessage m = QDBusMessage::createMethodCall(SYSTEMD_SERVICE, SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "EnableUnitFiles");
+    m << QStringList(DAEMON_UNIT) << false << false;
+    PendingReply<bool> reply(systemdCall(m), replyToVoid);
+    return reply.followedBy([]() {
+        return systemdCall(QDBusMessage::createMethodCall(SYSTEMD_SERVICE, SYSTEMD_PATH, SYSTEMD_MANAGER_INTERFACE, "Reload"));
+    });
+}
+
+// ====== DEVICE CLASS ======
+
+/*!
+ * \class libopenrazer::Device
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::Device class provides an abstraction for the OpenRazer daemon D-Bus interface for easy interaction from C++ applications.
+ *
+ * The methods of a device can be called from multiple threads at the same time. The serial and the capabilities are set up during construction and never change afterwards,
+ * the metadata and matrix frame state are locked while in use. properties() and commandQueue() always live in the main thread, their signals are delivered there.
+ */
+
+/*!
+ * \fn libopenrazer::Device::Device(QString serial, DeviceCache *cache)
+ *
+ * Constructs a new device object with the given \a serial.
+ *
+ * If \a cache is given and contains the device, the capabilities and static information like the name are taken from it instead of querying the daemon.
+ * Only the VID/PID is queried then, an entry stored for another VID/PID is ignored. Otherwise they get added to the cache.
+ */
+Device::Device(QString s, DeviceCache *cache) : Device(s, cache, true)
+{
+}
+
+/**
+ * Constructs the device, only querying the daemon if \a setup is set. createDevices() sets it up itself.
+ */
+Device::Device(const QString &s, DeviceCache *cache, bool setup)
+{
+    mSerial = s;
+    mObjectPath = "/org/razer/device/" + s;
+    this->cache = cache;
+    matrixCustomApplied = false;
+    mProperties = NULL;
+    mCommandQueue = NULL;
+    if(setup && !(loadFromCache() && checkCachedVidPid(getVidPidAsync()))) {
+        Introspect();
+        finishSetup();
+    }
+}
+
+/*!
+ * \fn QList<Device*> libopenrazer::Device::createDevices(const QStringList &serials, DeviceCache *cache)
+ *
+ * Constructs device objects for all \a serials, e.g. from getConnectedDevices(), using \a cache like the constructor does.
+ *
+ * Constructing the devices one by one waits for every introspection and metadata query in turn.
+ * This sends the queries of all devices first and only then waits for the replies, so the daemon handles them back to back and creating all devices takes about as long as the slowest one.
+ * The name, type, VID/PID and URLs of the devices are fetched as well, so they are available right away.
+ * Cached devices are only checked against their VID/PID, see the constructor.
+ *
+ * The caller takes ownership of the returned devices.
+ */
+QList<Device*> Device::createDevices(const QStringList &serials, DeviceCache *cache)
+{
+    return createDevices(serials, cache, std::function<void(Device*)>());
+}
+
+/**
+ * Creates the devices like createDevices(const QStringList &, DeviceCache *), calling \a ready with every device as soon as it is set up.
+ * The devices are returned in the order of \a serials.
+ */
+QList<Device*> Device::createDevices(const QStringList &serials, DeviceCache *cache, const std::function<void(Device*)> &ready)
+{
+    QList<Device*> devices;
+    QList<Device*> uncached;
+    QList<Device*> mismatched;
+    // The functions collecting the replies, one list per device
+    QList<QList<std::function<void()>>> finishers;
+
+    foreach(const QString &serial, serials) {
+        Device *device = new Device(serial, cache, false);
+        devices.append(device);
+        QList<std::function<void()>> deviceFinishers;
+        if(device->loadFromCache()) {
+            PendingReply<QList<int>> vidPid = device->getVidPidAsync();
+            deviceFinishers.append([device, vidPid, &mismatched]() {
+                if(!device->checkCachedVidPid(vidPid)) {
+                    mismatched.append(device);
+                }
+            });
+        } else {
+            uncached.append(device);
+            QDBusPendingCall introspection = QDBusMessageToPendingCall(device->prepareDeviceQDBusMessage("org.freedesktop.DBus.Introspectable", "Introspect"));
+            deviceFinishers.append([device, introspection]() {
+                QDBusPendingCall call(introspection);
+                call.waitForFinished();
+                device->parseIntrospection(call.reply());
+            });
+            device->prefetchValue(&deviceFinishers, "has_matrix", &Device::hasMatrixAsync);
+        }
+        device->prefetchValue(&deviceFinishers, "name", &Device::getDeviceNameAsync);
+        device->prefetchValue(&deviceFinishers, "type", &Device::getDeviceTypeAsync);
+        device->prefetchValue(&deviceFinishers, "vid_pid", &Device::getVidPidAsync);
+        device->prefetchValue(&deviceFinishers, "razer_urls", &Device::getRazerUrlsAsync);
+        finishers.append(deviceFinishers);
+    }
+
+    // All calls are sent, now collect the replies. The daemon answers in order, so a device is done before the replies of the next one are in.
+    for(int i=0; i<devices.size(); i++) {
+        Device *device = devices[i];
+        foreach(const std::function<void()> &finisher, finishers[i]) {
+            finisher();
+        }
+        if(mismatched.contains(device)) {
+            continue;
+        }
+        if(uncached.contains(device)) {
+            device->finishSetup();
+        }
+        device->storeInCache();
+        if(ready) {
+            ready(device);
+        }
+    }
+    // Rare enough to not be worth another round of pipelining
+    foreach(Device *device, mismatched) {
+        device->Introspect();
+        device->finishSetup();
+        if(ready) {
+            ready(device);
+        }
+    }
+    return devices;
+}
+
+/**
+ * Devices created by a job but not handed over yet. The ones never handed over, e.g. because the context was destroyed, are deleted with it.
+ */
+struct CreatedDevices {
+    QMutex mutex;
+    QList<Device*> devices;
+
+    ~CreatedDevices()
+    {
+        qDeleteAll(devices);
+    }
+    Device *take()
+    {
+        QMutexLocker locker(&mutex);
+        return devices.isEmpty() ? NULL : devices.takeFirst();
+    }
+};
+
+/**
+ * Creates devices on a worker thread and hands them over to the main thread, see Device::createDevicesAsync().
+ */
+class CreateDevicesJob : public QRunnable
+{
+public:
+    CreateDevicesJob(const std::function<void(const std::function<void(Device*)> &ready)> &create, QObject *context, const std::function<void(Device*)> &deviceReady, const std::function<void()> &finished)
+        : create(create), context(context), deviceReady(deviceReady), finished(finished) {}
+    void run() override
+    {
+        std::shared_ptr<CreatedDevices> created = std::make_shared<CreatedDevices>();
+        // Only read in the main thread, which the context lives in
+        QPointer<QObject> context = this->context;
+        std::function<void(Device*)> deviceReady = this->deviceReady;
+        std::function<void()> finished = this->finished;
+        create([created, context, deviceReady](Device *device) {
+            {
+                QMutexLocker locker(&created->mutex);
+                created->devices.append(device);
+            }
+            QTimer::singleShot(0, QCoreApplication::instance(), [created, context, deviceReady]() {
+                Device *device = context ? created->take() : NULL;
+                if(device != NULL) {
+                    deviceReady(device);
+                }
+            });
+        });
+        QTimer::singleShot(0, QCoreApplication::instance(), [created, context, deviceReady, finished]() {
+            if(!context) {
+                return;
+            }
+            // Zero timers started in another thread don't have to fire in order, so hand over what's left first
+            Device *device;
+            while((device = created->take()) != NULL) {
+                deviceReady(device);
+            }
+            if(finished) {
+                finished();
+            }
+        });
+    }
+private:
+    std::function<void(const std::function<void(Device*)> &ready)> create;
+    QPointer<QObject> context;
+    std::function<void(Device*)> deviceReady;
+    std::function<void()> finished;
+};
+
+/*!
+ * \fn void libopenrazer::Device::createDevicesAsync(const QStringList &serials, DeviceCache *cache, QObject *context, const std::function<void(Device*)> &deviceReady, const std::function<void()> &finished)
+ *
+ * Non-blocking variant of createDevices(). The devices are created on a worker thread, so the main thread doesn't wait for the daemon.
+ *
+ * \a deviceReady is called with every device as soon as it is set up and \a finished, if given, once all devices were handed over. Both are called in the main thread, which \a context has to live in,
+ * and not at all if \a context is destroyed before. The devices not handed over are deleted then. \a cache has to exist until all devices were created.
+ *
+ * The receiver of \a deviceReady takes ownership of the device.
+ */
+void Device::createDevicesAsync(const QStringList &serials, DeviceCache *cache, QObject *context, const std::function<void(Device*)> &deviceReady, const std::function<void()> &finished)
+{
+    QThreadPool::globalInstance()->start(new CreateDevicesJob([serials, cache](const std::function<void(Device*)> &ready) {
+        createDevices(serials, cache, ready);
+    }, context, deviceReady, finished));
+}
+
+/**
+ * Sets up the capabilities from the introspection data and adds the device to the cache.
+ */
+void Device::finishSetup()
 {
-    mSerial = s;
-    Introspect();
     setupCapabilities();
+    // Only needed to set up the capabilities
+    introspection.clear();
+    // Stored with the entry to identify the model
+    cachedValue("vid_pid", &Device::getVidPidAsync);
+    storeInCache();
 }
 
 /*
@@ -429,32 +1023,53 @@ Device::Device(QString s)
  */
 Device::~Device()
 {
+    delete mProperties;
+    delete mCommandQueue;
 }
 
 /**
- * Fill "introspection" variable with data from the dbus introspection xml
+ * Fill "introspection" variable with data from the dbus introspection xml, mapping every interface to the names of its members.
  */
 void Device::Introspect()
 {
-    QStringList intr;
-
     QDBusMessage m = prepareDeviceQDBusMessage("org.freedesktop.DBus.Introspectable", "Introspect");
-    QDomDocument doc = QDBusMessageToXML(m);
-
-    QDomNodeList nodes = doc.documentElement().childNodes();
-    for(int i = 0; i<nodes.count(); i++) {
-        // Check if "interface" and also not org.freedesktop.DBus.Introspectable
-        QDomElement element = nodes.at(i).toElement();
-        QString interfacename = element.attributeNode("name").value();
-
-        QDomNodeList methodnodes = element.childNodes();
-        for(int ii = 0; ii<methodnodes.count(); ii++) {
-            QDomElement methodelement = methodnodes.at(ii).toElement();
-            intr.append(interfacename + ";" + methodelement.attributeNode("name").value());
+    parseIntrospection(QDBusMessageToReply(m));
+}
+
+/**
+ * Parses the \a reply of the Introspect call into the "introspection" variable.
+ */
+void Device::parseIntrospection(const QDBusMessage &reply)
+{
+    if(reply.type() != QDBusMessage::ReplyMessage) {
+        // TODO: Handle error
+        printError(reply, Q_FUNC_INFO);
+        return;
+    }
+
+    QXmlStreamReader xml(reply.arguments()[0].toString());
+    QSet<QString> *members = NULL;
+    // <node> is depth 1, <interface> depth 2 and methods, signals and properties depth 3
+    int depth = 0;
+    while(!xml.atEnd()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+        if(token == QXmlStreamReader::EndElement) {
+            if(depth == 2) {
+                members = NULL;
+            }
+            depth--;
+        } else if(token == QXmlStreamReader::StartElement) {
+            depth++;
+            if(depth == 2 && xml.name() == QLatin1String("interface")) {
+                members = &introspection[internName(xml.attributes().value("name"))];
+            } else if(depth == 3 && members != NULL) {
+                members->insert(internName(xml.attributes().value("name")));
+            }
         }
-        intr.append(interfacename);
     }
-    introspection = intr;
+    if(xml.hasError()) {
+        qWarning() << "libopenrazer: Failed to parse introspection data of" << mSerial << ":" << xml.errorString();
+    }
 }
 
 /**
@@ -462,87 +1077,87 @@ void Device::Introspect()
  */
 void Device::setupCapabilities()
 {
-    capabilities.insert("name", true);
-    capabilities.insert("type", true);
-    capabilities.insert("firmware_version", true);
-    capabilities.insert("serial", true);
-    capabilities.insert("dpi", hasCapabilityInternal("razer.device.dpi", "setDPI"));
-    capabilities.insert("available_dpi", hasCapabilityInternal("razer.device.dpi", "availableDPI"));
-    capabilities.insert("brightness", hasCapabilityInternal("razer.device.lighting.brightness"));
-    capabilities.insert("get_brightness", hasCapabilityInternal("razer.device.lighting.brightness", "setBrightness"));
-    capabilities.insert("battery", hasCapabilityInternal("razer.device.power"));
-    capabilities.insert("poll_rate", hasCapabilityInternal("razer.device.misc", "setPollRate"));
-    capabilities.insert("mug", hasCapabilityInternal("razer.device.misc.mug", "isMugPresent"));
-    capabilities.insert("backlight", hasCapabilityInternal("razer.device.lighting.backlight", "getBacklightActive"));
-    capabilities.insert("kbd_layout", hasCapabilityInternal("razer.device.misc", "getKeyboardLayout"));
-
-    capabilities.insert("macro_logic", hasCapabilityInternal("razer.device.macro"));
+    capabilities.set(CAP_NAME, true);
+    capabilities.set(CAP_TYPE, true);
+    capabilities.set(CAP_FIRMWARE_VERSION, true);
+    capabilities.set(CAP_SERIAL, true);
+    capabilities.set(CAP_DPI, hasCapabilityInternal("razer.device.dpi", "setDPI"));
+    capabilities.set(CAP_AVAILABLE_DPI, hasCapabilityInternal("razer.device.dpi", "availableDPI"));
+    capabilities.set(CAP_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.brightness"));
+    capabilities.set(CAP_GET_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.brightness", "setBrightness"));
+    capabilities.set(CAP_BATTERY, hasCapabilityInternal("razer.device.power"));
+    capabilities.set(CAP_POLL_RATE, hasCapabilityInternal("razer.device.misc", "setPollRate"));
+    capabilities.set(CAP_MUG, hasCapabilityInternal("razer.device.misc.mug", "isMugPresent"));
+    capabilities.set(CAP_BACKLIGHT, hasCapabilityInternal("razer.device.lighting.backlight", "getBacklightActive"));
+    capabilities.set(CAP_KBD_LAYOUT, hasCapabilityInternal("razer.device.misc", "getKeyboardLayout"));
+
+    capabilities.set(CAP_MACRO_LOGIC, hasCapabilityInternal("razer.device.macro"));
 
     // Default device is a chroma so lighting capabilities
-    capabilities.insert("lighting", hasCapabilityInternal("razer.device.lighting.chroma"));
-    capabilities.insert("lighting_breath_single", hasCapabilityInternal("razer.device.lighting.chroma", "setBreathSingle"));
-    capabilities.insert("lighting_breath_dual", hasCapabilityInternal("razer.device.lighting.chroma", "setBreathDual"));
-    capabilities.insert("lighting_breath_triple", hasCapabilityInternal("razer.device.lighting.chroma", "setBreathTriple"));
-    capabilities.insert("lighting_breath_random", hasCapabilityInternal("razer.device.lighting.chroma", "setBreathRandom"));
-    capabilities.insert("lighting_charging", hasCapabilityInternal("razer.device.lighting.power"));
-    capabilities.insert("lighting_wave", hasCapabilityInternal("razer.device.lighting.chroma", "setWave"));
-    capabilities.insert("lighting_reactive", hasCapabilityInternal("razer.device.lighting.chroma", "setReactive"));
-    capabilities.insert("lighting_none", hasCapabilityInternal("razer.device.lighting.chroma", "setNone"));
-    capabilities.insert("lighting_spectrum", hasCapabilityInternal("razer.device.lighting.chroma", "setSpectrum"));
-    capabilities.insert("lighting_static", hasCapabilityInternal("razer.device.lighting.chroma", "setStatic"));
-
-    capabilities.insert("lighting_starlight_single", hasCapabilityInternal("razer.device.lighting.chroma", "setStarlightSingle"));
-    capabilities.insert("lighting_starlight_dual", hasCapabilityInternal("razer.device.lighting.chroma", "setStarlightDual"));
-    capabilities.insert("lighting_starlight_random", hasCapabilityInternal("razer.device.lighting.chroma", "setStarlightRandom"));
-
-    capabilities.insert("lighting_ripple", hasCapabilityInternal("razer.device.lighting.custom", "setRipple"));
-    capabilities.insert("lighting_ripple_random", hasCapabilityInternal("razer.device.lighting.custom", "setRippleRandomColour"));
-
-    capabilities.insert("lighting_bw2013", hasCapabilityInternal("razer.device.lighting.bw2013"));
-    capabilities.insert("lighting_static_bw2013", hasCapabilityInternal("razer.device.lighting.bw2013", "setStatic"));
-    capabilities.insert("lighting_pulsate", hasCapabilityInternal("razer.device.lighting.bw2013", "setPulsate"));
-
-    capabilities.insert("lighting_profile_leds", hasCapabilityInternal("razer.device.lighting.profile_led"));
-
-    capabilities.insert("lighting_led_matrix", hasMatrix());
-    capabilities.insert("lighting_led_single", hasCapabilityInternal("razer.device.lighting.chroma", "setKey"));
+    capabilities.set(CAP_LIGHTING, hasCapabilityInternal("razer.device.lighting.chroma"));
+    capabilities.set(CAP_LIGHTING_BREATH_SINGLE, hasCapabilityInternal("razer.device.lighting.chroma", "setBreathSingle"));
+    capabilities.set(CAP_LIGHTING_BREATH_DUAL, hasCapabilityInternal("razer.device.lighting.chroma", "setBreathDual"));
+    capabilities.set(CAP_LIGHTING_BREATH_TRIPLE, hasCapabilityInternal("razer.device.lighting.chroma", "setBreathTriple"));
+    capabilities.set(CAP_LIGHTING_BREATH_RANDOM, hasCapabilityInternal("razer.device.lighting.chroma", "setBreathRandom"));
+    capabilities.set(CAP_LIGHTING_CHARGING, hasCapabilityInternal("razer.device.lighting.power"));
+    capabilities.set(CAP_LIGHTING_WAVE, hasCapabilityInternal("razer.device.lighting.chroma", "setWave"));
+    capabilities.set(CAP_LIGHTING_REACTIVE, hasCapabilityInternal("razer.device.lighting.chroma", "setReactive"));
+    capabilities.set(CAP_LIGHTING_NONE, hasCapabilityInternal("razer.device.lighting.chroma", "setNone"));
+    capabilities.set(CAP_LIGHTING_SPECTRUM, hasCapabilityInternal("razer.device.lighting.chroma", "setSpectrum"));
+    capabilities.set(CAP_LIGHTING_STATIC, hasCapabilityInternal("razer.device.lighting.chroma", "setStatic"));
+
+    capabilities.set(CAP_LIGHTING_STARLIGHT_SINGLE, hasCapabilityInternal("razer.device.lighting.chroma", "setStarlightSingle"));
+    capabilities.set(CAP_LIGHTING_STARLIGHT_DUAL, hasCapabilityInternal("razer.device.lighting.chroma", "setStarlightDual"));
+    capabilities.set(CAP_LIGHTING_STARLIGHT_RANDOM, hasCapabilityInternal("razer.device.lighting.chroma", "setStarlightRandom"));
+
+    capabilities.set(CAP_LIGHTING_RIPPLE, hasCapabilityInternal("razer.device.lighting.custom", "setRipple"));
+    capabilities.set(CAP_LIGHTING_RIPPLE_RANDOM, hasCapabilityInternal("razer.device.lighting.custom", "setRippleRandomColour"));
+
+    capabilities.set(CAP_LIGHTING_BW2013, hasCapabilityInternal("razer.device.lighting.bw2013"));
+    capabilities.set(CAP_LIGHTING_STATIC_BW2013, hasCapabilityInternal("razer.device.lighting.bw2013", "setStatic"));
+    capabilities.set(CAP_LIGHTING_PULSATE, hasCapabilityInternal("razer.device.lighting.bw2013", "setPulsate"));
+
+    capabilities.set(CAP_LIGHTING_PROFILE_LEDS, hasCapabilityInternal("razer.device.lighting.profile_led"));
+
+    capabilities.set(CAP_LIGHTING_LED_MATRIX, hasMatrix());
+    capabilities.set(CAP_LIGHTING_LED_SINGLE, hasCapabilityInternal("razer.device.lighting.chroma", "setKey"));
 
     // Mouse lighting attrs
-    capabilities.insert("lighting_logo", hasCapabilityInternal("razer.device.lighting.logo"));
-    capabilities.insert("lighting_logo_active", hasCapabilityInternal("razer.device.lighting.logo", "setLogoActive"));
-    capabilities.insert("lighting_logo_blinking", hasCapabilityInternal("razer.device.lighting.logo", "setLogoBlinking"));
-    capabilities.insert("lighting_logo_brightness", hasCapabilityInternal("razer.device.lighting.logo", "setLogoBrightness"));
-    capabilities.insert("get_lighting_logo_brightness", hasCapabilityInternal("razer.device.lighting.logo", "getLogoBrightness"));
-    capabilities.insert("lighting_logo_pulsate", hasCapabilityInternal("razer.device.lighting.logo", "setLogoPulsate"));
-    capabilities.insert("lighting_logo_spectrum", hasCapabilityInternal("razer.device.lighting.logo", "setLogoSpectrum"));
-    capabilities.insert("lighting_logo_static", hasCapabilityInternal("razer.device.lighting.logo", "setLogoStatic"));
-    capabilities.insert("lighting_logo_none", hasCapabilityInternal("razer.device.lighting.logo", "setLogoNone"));
-    capabilities.insert("lighting_logo_reactive", hasCapabilityInternal("razer.device.lighting.logo", "setLogoReactive"));
-    capabilities.insert("lighting_logo_breath_single", hasCapabilityInternal("razer.device.lighting.logo", "setLogoBreathSingle"));
-    capabilities.insert("lighting_logo_breath_dual", hasCapabilityInternal("razer.device.lighting.logo", "setLogoBreathDual"));
-    capabilities.insert("lighting_logo_breath_random", hasCapabilityInternal("razer.device.lighting.logo", "setLogoBreathRandom"));
-
-    capabilities.insert("lighting_scroll", hasCapabilityInternal("razer.device.lighting.scroll"));
-    capabilities.insert("lighting_scroll_active", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollActive"));
-    capabilities.insert("lighting_scroll_blinking", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBlinking"));
-    capabilities.insert("lighting_scroll_brightness", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBrightness"));
-    capabilities.insert("get_lighting_scroll_brightness", hasCapabilityInternal("razer.device.lighting.scroll", "getScrollBrightness"));
-    capabilities.insert("lighting_scroll_pulsate", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollPulsate"));
-    capabilities.insert("lighting_scroll_spectrum", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollSpectrum"));
-    capabilities.insert("lighting_scroll_static", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollStatic"));
-    capabilities.insert("lighting_scroll_none", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollNone"));
-    capabilities.insert("lighting_scroll_reactive", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollReactive"));
-    capabilities.insert("lighting_scroll_breath_single", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBreathSingle"));
-    capabilities.insert("lighting_scroll_breath_dual", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBreathDual"));
-    capabilities.insert("lighting_scroll_breath_random", hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBreathRandom"));
-
-    capabilities.insert("lighting_backlight", hasCapabilityInternal("razer.device.lighting.backlight"));
-    capabilities.insert("lighting_backlight_active", hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightActive"));
-    capabilities.insert("get_lighting_backlight_effect", hasCapabilityInternal("razer.device.lighting.backlight", "getBacklightEffect"));
-    capabilities.insert("lighting_backlight_brightness", hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightBrightness"));
-    capabilities.insert("get_lighting_backlight_brightness", hasCapabilityInternal("razer.device.lighting.backlight", "getBacklightBrightness"));
-    capabilities.insert("lighting_backlight_spectrum", hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightSpectrum"));
-    capabilities.insert("lighting_backlight_static", hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightStatic"));
+    capabilities.set(CAP_LIGHTING_LOGO, hasCapabilityInternal("razer.device.lighting.logo"));
+    capabilities.set(CAP_LIGHTING_LOGO_ACTIVE, hasCapabilityInternal("razer.device.lighting.logo", "setLogoActive"));
+    capabilities.set(CAP_LIGHTING_LOGO_BLINKING, hasCapabilityInternal("razer.device.lighting.logo", "setLogoBlinking"));
+    capabilities.set(CAP_LIGHTING_LOGO_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.logo", "setLogoBrightness"));
+    capabilities.set(CAP_GET_LIGHTING_LOGO_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.logo", "getLogoBrightness"));
+    capabilities.set(CAP_LIGHTING_LOGO_PULSATE, hasCapabilityInternal("razer.device.lighting.logo", "setLogoPulsate"));
+    capabilities.set(CAP_LIGHTING_LOGO_SPECTRUM, hasCapabilityInternal("razer.device.lighting.logo", "setLogoSpectrum"));
+    capabilities.set(CAP_LIGHTING_LOGO_STATIC, hasCapabilityInternal("razer.device.lighting.logo", "setLogoStatic"));
+    capabilities.set(CAP_LIGHTING_LOGO_NONE, hasCapabilityInternal("razer.device.lighting.logo", "setLogoNone"));
+    capabilities.set(CAP_LIGHTING_LOGO_REACTIVE, hasCapabilityInternal("razer.device.lighting.logo", "setLogoReactive"));
+    capabilities.set(CAP_LIGHTING_LOGO_BREATH_SINGLE, hasCapabilityInternal("razer.device.lighting.logo", "setLogoBreathSingle"));
+    capabilities.set(CAP_LIGHTING_LOGO_BREATH_DUAL, hasCapabilityInternal("razer.device.lighting.logo", "setLogoBreathDual"));
+    capabilities.set(CAP_LIGHTING_LOGO_BREATH_RANDOM, hasCapabilityInternal("razer.device.lighting.logo", "setLogoBreathRandom"));
+
+    capabilities.set(CAP_LIGHTING_SCROLL, hasCapabilityInternal("razer.device.lighting.scroll"));
+    capabilities.set(CAP_LIGHTING_SCROLL_ACTIVE, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollActive"));
+    capabilities.set(CAP_LIGHTING_SCROLL_BLINKING, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBlinking"));
+    capabilities.set(CAP_LIGHTING_SCROLL_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBrightness"));
+    capabilities.set(CAP_GET_LIGHTING_SCROLL_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.scroll", "getScrollBrightness"));
+    capabilities.set(CAP_LIGHTING_SCROLL_PULSATE, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollPulsate"));
+    capabilities.set(CAP_LIGHTING_SCROLL_SPECTRUM, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollSpectrum"));
+    capabilities.set(CAP_LIGHTING_SCROLL_STATIC, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollStatic"));
+    capabilities.set(CAP_LIGHTING_SCROLL_NONE, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollNone"));
+    capabilities.set(CAP_LIGHTING_SCROLL_REACTIVE, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollReactive"));
+    capabilities.set(CAP_LIGHTING_SCROLL_BREATH_SINGLE, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBreathSingle"));
+    capabilities.set(CAP_LIGHTING_SCROLL_BREATH_DUAL, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBreathDual"));
+    capabilities.set(CAP_LIGHTING_SCROLL_BREATH_RANDOM, hasCapabilityInternal("razer.device.lighting.scroll", "setScrollBreathRandom"));
+
+    capabilities.set(CAP_LIGHTING_BACKLIGHT, hasCapabilityInternal("razer.device.lighting.backlight"));
+    capabilities.set(CAP_LIGHTING_BACKLIGHT_ACTIVE, hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightActive"));
+    capabilities.set(CAP_GET_LIGHTING_BACKLIGHT_EFFECT, hasCapabilityInternal("razer.device.lighting.backlight", "getBacklightEffect"));
+    capabilities.set(CAP_LIGHTING_BACKLIGHT_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightBrightness"));
+    capabilities.set(CAP_GET_LIGHTING_BACKLIGHT_BRIGHTNESS, hasCapabilityInternal("razer.device.lighting.backlight", "getBacklightBrightness"));
+    capabilities.set(CAP_LIGHTING_BACKLIGHT_SPECTRUM, hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightSpectrum"));
+    capabilities.set(CAP_LIGHTING_BACKLIGHT_STATIC, hasCapabilityInternal("razer.device.lighting.backlight", "setBacklightStatic"));
 }
 
 /*!
@@ -596,27 +1211,311 @@ QString Device::serial()
     return mSerial;
 }
 
+/**
+ * Names of the capabilities as used by the pylib, in the order of the Capability enum. Generated with ./scripts/capabilities_to_cpp.sh names
+ */
+static const char *const capabilityNames[CAP_COUNT] = {
+    "name",
+    "type",
+    "firmware_version",
+    "serial",
+    "dpi",
+    "available_dpi",
+    "brightness",
+    "get_brightness",
+    "battery",
+    "poll_rate",
+    "mug",
+    "backlight",
+    "kbd_layout",
+    "macro_logic",
+    "lighting",
+    "lighting_breath_single",
+    "lighting_breath_dual",
+    "lighting_breath_triple",
+    "lighting_breath_random",
+    "lighting_charging",
+    "lighting_wave",
+    "lighting_reactive",
+    "lighting_none",
+    "lighting_spectrum",
+    "lighting_static",
+    "lighting_starlight_single",
+    "lighting_starlight_dual",
+    "lighting_starlight_random",
+    "lighting_ripple",
+    "lighting_ripple_random",
+    "lighting_bw2013",
+    "lighting_static_bw2013",
+    "lighting_pulsate",
+    "lighting_profile_leds",
+    "lighting_led_matrix",
+    "lighting_led_single",
+    "lighting_logo",
+    "lighting_logo_active",
+    "lighting_logo_blinking",
+    "lighting_logo_brightness",
+    "get_lighting_logo_brightness",
+    "lighting_logo_pulsate",
+    "lighting_logo_spectrum",
+    "lighting_logo_static",
+    "lighting_logo_none",
+    "lighting_logo_reactive",
+    "lighting_logo_breath_single",
+    "lighting_logo_breath_dual",
+    "lighting_logo_breath_random",
+    "lighting_scroll",
+    "lighting_scroll_active",
+    "lighting_scroll_blinking",
+    "lighting_scroll_brightness",
+    "get_lighting_scroll_brightness",
+    "lighting_scroll_pulsate",
+    "lighting_scroll_spectrum",
+    "lighting_scroll_static",
+    "lighting_scroll_none",
+    "lighting_scroll_reactive",
+    "lighting_scroll_breath_single",
+    "lighting_scroll_breath_dual",
+    "lighting_scroll_breath_random",
+    "lighting_backlight",
+    "lighting_backlight_active",
+    "get_lighting_backlight_effect",
+    "lighting_backlight_brightness",
+    "get_lighting_backlight_brightness",
+    "lighting_backlight_spectrum",
+    "lighting_backlight_static",
+};
+
+/**
+ * Returns the index of the capability with the given \a name in the Capability enum, or -1 if there is no such capability.
+ */
+int capabilityIndex(const QString &name)
+{
+    static const QHash<QString, int> capabilityByName = []() {
+        QHash<QString, int> hash;
+        for(int i = 0; i < CAP_COUNT; i++) {
+            hash.insert(capabilityNames[i], i);
+        }
+        return hash;
+    }();
+    return capabilityByName.value(name, -1);
+}
+
 /**
  * Internal method to determine whether a device has a given capability based on interface and method names.
  */
 bool Device::hasCapabilityInternal(const QString &interface, const QString &method)
 {
-    if(method.isNull()) {
-        return introspection.contains(interface);
+    QHash<QString, QSet<QString>>::const_iterator it = introspection.constFind(interface);
+    if(it == introspection.constEnd()) {
+        return false;
     }
-    return introspection.contains(interface + ";" + method);
+    return method.isNull() || it->contains(method);
 }
 
 /*!
  * \fn bool libopenrazer::Device::hasCapability(const QString &name)
  *
  * Returns if a device has a given capability with the given \a name. Capability strings can be listed with getAllCapabilities() or viewed in \c libopenrazer.cpp.
+ * Prefer the overload taking a Capability, it doesn't have to look up the name.
  *
  * \sa getAllCapabilities()
  */
 bool Device::hasCapability(const QString &name)
 {
-    return capabilities.value(name);
+    int index = capabilityIndex(name);
+    return index != -1 && capabilities.test(index);
+}
+
+/*!
+ * \fn bool libopenrazer::Device::hasCapability(Capability capability)
+ *
+ * Returns if a device has the given \a capability.
+ *
+ * \sa capabilityName()
+ */
+bool Device::hasCapability(Capability capability)
+{
+    return capabilities.test(capability);
+}
+
+/**
+ * Fills the capabilities and metadata from the cache. Returns false if the device isn't cached.
+ */
+bool Device::loadFromCache()
+{
+    if(cache == NULL) {
+        return false;
+    }
+    QJsonObject entry = cache->entry(mSerial);
+    QJsonObject cachedCapabilities = entry.value("capabilities").toObject();
+    for(int i = 0; i < CAP_COUNT; i++) {
+        QJsonValue value = cachedCapabilities.value(capabilityNames[i]);
+        // Also covers entries written by an older libopenrazer without this capability
+        if(!value.isBool()) {
+            capabilities.reset();
+            return false;
+        }
+        capabilities.set(i, value.toBool());
+    }
+    QMutexLocker locker(&mutex);
+    metadata = entry.value("metadata").toObject();
+    return true;
+}
+
+/**
+ * Writes the capabilities and metadata to the cache.
+ */
+void Device::storeInCache()
+{
+    if(cache == NULL) {
+        return;
+    }
+    QJsonObject cachedCapabilities;
+    for(int i = 0; i < CAP_COUNT; i++) {
+        cachedCapabilities.insert(capabilityNames[i], bool(capabilities.test(i)));
+    }
+    QJsonObject entry;
+    entry.insert("capabilities", cachedCapabilities);
+    {
+        QMutexLocker locker(&mutex);
+        entry.insert("metadata", metadata);
+    }
+    cache->setEntry(mSerial, entry);
+}
+
+/**
+ * Conversions of the cached metadata values from and to JSON.
+ */
+QJsonValue toCacheValue(const QString &value)
+{
+    return value;
+}
+
+QJsonValue toCacheValue(bool value)
+{
+    return value;
+}
+
+QJsonValue toCacheValue(int value)
+{
+    return value;
+}
+
+QJsonValue toCacheValue(const QVariantHash &value)
+{
+    return QJsonObject::fromVariantHash(value);
+}
+
+QJsonValue toCacheValue(const QList<int> &value)
+{
+    QJsonArray array;
+    foreach(int i, value) {
+        array.append(i);
+    }
+    return array;
+}
+
+void fromCacheValue(const QJsonValue &value, QString *out)
+{
+    *out = value.toString();
+}
+
+void fromCacheValue(const QJsonValue &value, bool *out)
+{
+    *out = value.toBool();
+}
+
+void fromCacheValue(const QJsonValue &value, int *out)
+{
+    *out = value.toInt();
+}
+
+void fromCacheValue(const QJsonValue &value, QVariantHash *out)
+{
+    *out = value.toObject().toVariantHash();
+}
+
+void fromCacheValue(const QJsonValue &value, QList<int> *out)
+{
+    foreach(const QJsonValue &i, value.toArray()) {
+        out->append(i.toInt());
+    }
+}
+
+/**
+ * Returns the metadata value \a key, which never changes for a device. It is only queried with \a call if it isn't known yet, successful replies are remembered and written to the cache.
+ */
+template<typename T>
+T Device::cachedValue(const QString &key, PendingReply<T> (Device::*call)())
+{
+    T value;
+    {
+        QMutexLocker locker(&mutex);
+        QJsonObject::const_iterator it = metadata.constFind(key);
+        if(it != metadata.constEnd()) {
+            fromCacheValue(*it, &value);
+            return value;
+        }
+    }
+    // Not locked while waiting, another thread querying the same value at the same time only costs a call
+    PendingReply<T> reply = (this->*call)();
+    value = reply.value();
+    if(!reply.isError()) {
+        {
+            QMutexLocker locker(&mutex);
+            metadata.insert(key, toCacheValue(value));
+        }
+        storeInCache();
+    }
+    return value;
+}
+
+/**
+ * Checks the VID/PID in \a reply against the one the cache entry was stored with, as the serial alone doesn't identify a device:
+ * some report a placeholder serial, so another model can show up with the serial of a cached one.
+ * On a mismatch the cached capabilities and metadata are dropped and false is returned, the device has to be introspected again.
+ * Returns true if the reply failed, the entry can't be checked then.
+ */
+bool Device::checkCachedVidPid(const PendingReply<QList<int>> &reply)
+{
+    QList<int> vidPid = reply.value();
+    if(reply.isError()) {
+        return true;
+    }
+    QMutexLocker locker(&mutex);
+    QList<int> cached;
+    fromCacheValue(metadata.value("vid_pid"), &cached);
+    if(cached == vidPid) {
+        return true;
+    }
+    qWarning() << "libopenrazer: Cache entry of" << mSerial << "is for another VID/PID, ignoring it.";
+    capabilities.reset();
+    metadata = QJsonObject();
+    metadata.insert("vid_pid", toCacheValue(vidPid));
+    return false;
+}
+
+/**
+ * Sends the query for the metadata value \a key with \a call if it isn't known yet and appends a function storing the reply to \a finishers.
+ */
+template<typename T>
+void Device::prefetchValue(QList<std::function<void()>> *finishers, const QString &key, PendingReply<T> (Device::*call)())
+{
+    {
+        QMutexLocker locker(&mutex);
+        if(metadata.contains(key)) {
+            return;
+        }
+    }
+    PendingReply<T> reply = (this->*call)();
+    finishers->append([this, key, reply]() {
+        T value = reply.value();
+        if(!reply.isError()) {
+            QMutexLocker locker(&mutex);
+            metadata.insert(key, toCacheValue(value));
+        }
+    });
 }
 
 /*!
@@ -628,7 +1527,170 @@ bool Device::hasCapability(const QString &name)
  */
 QHash<QString, bool> Device::getAllCapabilities()
 {
-    return capabilities;
+    QHash<QString, bool> hash;
+    for(int i = 0; i < CAP_COUNT; i++) {
+        hash.insert(capabilityNames[i], capabilities.test(i));
+    }
+    return hash;
+}
+
+/*!
+ * \fn QString libopenrazer::capabilityName(Capability capability)
+ *
+ * Returns the name of the given \a capability, as accepted by Device::hasCapability(const QString &name).
+ */
+QString capabilityName(Capability capability)
+{
+    return capabilityNames[capability];
+}
+
+/**
+ * Moves \a object created by a device in any thread to the main thread, which runs the event loop delivering its replies.
+ */
+static void moveToMainThread(QObject *object)
+{
+    if(QCoreApplication::instance() != NULL) {
+        object->moveToThread(QCoreApplication::instance()->thread());
+    }
+}
+
+/*!
+ * \fn DeviceProperties *libopenrazer::Device::properties()
+ *
+ * Returns the last known values of the settings of this device, see DeviceProperties. The object is owned by the device.
+ */
+DeviceProperties *Device::properties()
+{
+    QMutexLocker locker(&mutex);
+    if(mProperties == NULL) {
+        mProperties = new DeviceProperties(this);
+        moveToMainThread(mProperties);
+    }
+    return mProperties;
+}
+
+/*!
+ * \fn CommandQueue *libopenrazer::Device::commandQueue()
+ *
+ * Returns the queue used by the \c ...Queued() setters of this device. The object is owned by the device.
+ */
+CommandQueue *Device::commandQueue()
+{
+    QMutexLocker locker(&mutex);
+    if(mCommandQueue == NULL) {
+        mCommandQueue = new CommandQueue();
+        moveToMainThread(mCommandQueue);
+    }
+    return mCommandQueue;
+}
+
+/*!
+ * \fn DeviceBatch libopenrazer::Device::batch()
+ *
+ * Returns an empty batch of calls to this device, which are sent together once it is committed.
+ *
+ * \sa DeviceBatch
+ */
+DeviceBatch Device::batch()
+{
+    return DeviceBatch(this);
+}
+
+/**
+ * Updates the known value of \a property to \a value after it was set, if the properties are in use.
+ */
+void Device::updateProperty(DeviceProperties::Property property, const QVariant &value)
+{
+    DeviceProperties *properties;
+    {
+        // Not locked while emitting valueChanged(), receivers may call back into the device
+        QMutexLocker locker(&mutex);
+        properties = mProperties;
+    }
+    if(properties != NULL) {
+        properties->update(property, value);
+    }
+}
+
+/**
+ * Forgets the known value of \a property, if the properties are in use.
+ */
+void Device::invalidateProperty(DeviceProperties::Property property)
+{
+    DeviceProperties *properties;
+    {
+        QMutexLocker locker(&mutex);
+        properties = mProperties;
+    }
+    if(properties != NULL) {
+        properties->invalidate(property);
+    }
+}
+
+/**
+ * Sends the setter call \a m and updates \a property to \a value once the daemon confirmed it, if the properties are in use.
+ */
+PendingReply<bool> Device::sendSetterAsync(const QDBusMessage &m, DeviceProperties::Property property, const QVariant &value)
+{
+    QPointer<DeviceProperties> properties;
+    {
+        QMutexLocker locker(&mutex);
+        properties = mProperties;
+    }
+    CapturedCalls *captured = capturedCalls();
+    if(captured != NULL) {
+        // Not sent yet, whoever sends it passes the reply on, see DeviceBatch
+        captured->append(m, [properties, property, value](const QDBusMessage &reply) {
+            if(properties != NULL) {
+                properties->applyReply(reply, property, value);
+            }
+        });
+        return PendingReply<bool>(QDBusPendingCall::fromCompletedCall(m.createReply()), replyToVoid, m);
+    }
+    PendingReply<bool> reply = QDBusMessageToVoidAsync(m);
+    if(properties != NULL) {
+        properties->updateOnReply(reply.pendingCall(), property, value);
+    }
+    return reply;
+}
+
+/**
+ * Returns the reply handler for the \c ...Queued() setters. They update \a property before the call is answered, so a failed call has to fetch the actual value again.
+ */
+CallCallback Device::refetchOnError(DeviceProperties::Property property)
+{
+    // Only called while the command queue, and so the device, exists
+    return [this, property](const QDBusMessage &reply) {
+        if(reply.type() != QDBusMessage::ErrorMessage) {
+            return;
+        }
+        DeviceProperties *properties;
+        {
+            QMutexLocker locker(&mutex);
+            properties = mProperties;
+        }
+        if(properties != NULL) {
+            properties->invalidate(property);
+            properties->refresh(property);
+        }
+    };
+}
+
+/**
+ * Sends the lighting effect \a m. An effect replaces what a custom frame shows, so the next frame has to be sent completely again.
+ */
+PendingReply<bool> Device::sendEffectAsync(const QDBusMessage &m)
+{
+    CapturedCalls *captured = capturedCalls();
+    if(captured != NULL) {
+        // Not sent yet, so a frame sent before the batch still counts until the effect arrived
+        captured->append(m, [this](const QDBusMessage &) {
+            invalidateMatrixFrame();
+        });
+        return PendingReply<bool>(QDBusPendingCall::fromCompletedCall(m.createReply()), replyToVoid, m);
+    }
+    invalidateMatrixFrame();
+    return QDBusMessageToVoidAsync(m);
 }
 
 /*!
@@ -671,8 +1733,18 @@ QString Device::getPngUrl()
  */
 QString Device::getDeviceMode()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getDeviceMode");
-    return QDBusMessageToString(m);
+    return getDeviceModeAsync().value();
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::Device::getDeviceModeAsync()
+ *
+ * Non-blocking variant of getDeviceMode().
+ */
+PendingReply<QString> Device::getDeviceModeAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getDeviceMode(mObjectPath);
+    return QDBusMessageToStringAsync(m);
 }
 
 /*!
@@ -685,16 +1757,22 @@ QString Device::getDeviceMode()
  *
  * Returns if the D-Bus call was successful.
  *
- * \sa getDeviceMode()
+ * \sa getDeviceMode()
+ */
+bool Device::setDeviceMode(uchar mode_id, uchar param)
+{
+    return !setDeviceModeAsync(mode_id, param).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setDeviceModeAsync(uchar mode_id, uchar param)
+ *
+ * Non-blocking variant of setDeviceMode().
  */
-bool Device::setDeviceMode(uchar mode_id, uchar param)
+PendingReply<bool> Device::setDeviceModeAsync(uchar mode_id, uchar param)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "setDeviceMode");
-    QList<QVariant> args;
-    args.append(mode_id);
-    args.append(param);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    QDBusMessage m = proxy::razer::device::misc::setDeviceMode(mObjectPath, mode_id, param);
+    return QDBusMessageToVoidAsync(m);
 }
 
 /*!
@@ -704,8 +1782,18 @@ bool Device::setDeviceMode(uchar mode_id, uchar param)
  */
 QString Device::getDeviceName()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getDeviceName");
-    return QDBusMessageToString(m);
+    return cachedValue("name", &Device::getDeviceNameAsync);
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::Device::getDeviceNameAsync()
+ *
+ * Non-blocking variant of getDeviceName().
+ */
+PendingReply<QString> Device::getDeviceNameAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getDeviceName(mObjectPath);
+    return QDBusMessageToStringAsync(m);
 }
 
 /*!
@@ -715,16 +1803,18 @@ QString Device::getDeviceName()
  */
 QString Device::getDeviceType()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getDeviceType");
-    QString devicetype = QDBusMessageToString(m);
-    // Fix up devicetype for old versions of the daemon (PR #445 in openrazer/openrazer).
-    // TODO: Remove once the new daemon version was released (and was out for a while).
-    if(devicetype == "firefly") {
-        devicetype = "mousemat";
-    } else if(devicetype == "orbweaver" || devicetype == "tartarus") {
-        devicetype = "keypad";
-    }
-    return devicetype;
+    return cachedValue("type", &Device::getDeviceTypeAsync);
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::Device::getDeviceTypeAsync()
+ *
+ * Non-blocking variant of getDeviceType().
+ */
+PendingReply<QString> Device::getDeviceTypeAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getDeviceType(mObjectPath);
+    return PendingReply<QString>(QDBusMessageToPendingCall(m), replyToDeviceType, m);
 }
 
 /*!
@@ -734,8 +1824,18 @@ QString Device::getDeviceType()
  */
 QString Device::getDriverVersion()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getDriverVersion");
-    return QDBusMessageToString(m);
+    return getDriverVersionAsync().value();
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::Device::getDriverVersionAsync()
+ *
+ * Non-blocking variant of getDriverVersion().
+ */
+PendingReply<QString> Device::getDriverVersionAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getDriverVersion(mObjectPath);
+    return QDBusMessageToStringAsync(m);
 }
 
 /*!
@@ -745,8 +1845,18 @@ QString Device::getDriverVersion()
  */
 QString Device::getFirmwareVersion()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getFirmware");
-    return QDBusMessageToString(m);
+    return getFirmwareVersionAsync().value();
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::Device::getFirmwareVersionAsync()
+ *
+ * Non-blocking variant of getFirmwareVersion().
+ */
+PendingReply<QString> Device::getFirmwareVersionAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getFirmware(mObjectPath);
+    return QDBusMessageToStringAsync(m);
 }
 
 /*!
@@ -756,8 +1866,18 @@ QString Device::getFirmwareVersion()
  */
 QString Device::getKeyboardLayout()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getKeyboardLayout");
-    return QDBusMessageToString(m);
+    return cachedValue("keyboard_layout", &Device::getKeyboardLayoutAsync);
+}
+
+/*!
+ * \fn PendingReply<QString> libopenrazer::Device::getKeyboardLayoutAsync()
+ *
+ * Non-blocking variant of getKeyboardLayout().
+ */
+PendingReply<QString> Device::getKeyboardLayoutAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getKeyboardLayout(mObjectPath);
+    return QDBusMessageToStringAsync(m);
 }
 
 /*!
@@ -769,9 +1889,18 @@ QString Device::getKeyboardLayout()
  */
 QVariantHash Device::getRazerUrls()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getRazerUrls");
-    QString ret = QDBusMessageToString(m);
-    return QJsonDocument::fromJson(ret.toUtf8()).object().toVariantHash();
+    return cachedValue("razer_urls", &Device::getRazerUrlsAsync);
+}
+
+/*!
+ * \fn PendingReply<QVariantHash> libopenrazer::Device::getRazerUrlsAsync()
+ *
+ * Non-blocking variant of getRazerUrls().
+ */
+PendingReply<QVariantHash> Device::getRazerUrlsAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getRazerUrls(mObjectPath);
+    return PendingReply<QVariantHash>(QDBusMessageToPendingCall(m), replyToJsonHash, m);
 }
 
 /*!
@@ -781,8 +1910,7 @@ QVariantHash Device::getRazerUrls()
  */
 int Device::getVid()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getVidPid");
-    return QDBusMessageToIntArray(m)[0];
+    return cachedValue("vid_pid", &Device::getVidPidAsync)[0];
 }
 
 /*!
@@ -792,8 +1920,20 @@ int Device::getVid()
  */
 int Device::getPid()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getVidPid");
-    return QDBusMessageToIntArray(m)[1];
+    return cachedValue("vid_pid", &Device::getVidPidAsync)[1];
+}
+
+/*!
+ * \fn PendingReply<QList<int>> libopenrazer::Device::getVidPidAsync()
+ *
+ * Non-blocking call returning the USB vendor ID and product ID as a list with two entries.
+ *
+ * \sa getVid(), getPid()
+ */
+PendingReply<QList<int>> Device::getVidPidAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getVidPid(mObjectPath);
+    return QDBusMessageToIntArrayAsync(m);
 }
 
 /*!
@@ -803,8 +1943,18 @@ int Device::getPid()
  */
 bool Device::hasDedicatedMacroKeys()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "hasDedicatedMacroKeys");
-    return QDBusMessageToBool(m);
+    return hasDedicatedMacroKeysAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::hasDedicatedMacroKeysAsync()
+ *
+ * Non-blocking variant of hasDedicatedMacroKeys().
+ */
+PendingReply<bool> Device::hasDedicatedMacroKeysAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::hasDedicatedMacroKeys(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -814,8 +1964,18 @@ bool Device::hasDedicatedMacroKeys()
  */
 bool Device::hasMatrix()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "hasMatrix");
-    return QDBusMessageToBool(m);
+    return cachedValue("has_matrix", &Device::hasMatrixAsync);
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::hasMatrixAsync()
+ *
+ * Non-blocking variant of hasMatrix().
+ */
+PendingReply<bool> Device::hasMatrixAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::hasMatrix(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -825,8 +1985,18 @@ bool Device::hasMatrix()
  */
 QList<int> Device::getMatrixDimensions()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getMatrixDimensions");
-    return QDBusMessageToIntArray(m);
+    return cachedValue("matrix_dimensions", &Device::getMatrixDimensionsAsync);
+}
+
+/*!
+ * \fn PendingReply<QList<int>> libopenrazer::Device::getMatrixDimensionsAsync()
+ *
+ * Non-blocking variant of getMatrixDimensions().
+ */
+PendingReply<QList<int>> Device::getMatrixDimensionsAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getMatrixDimensions(mObjectPath);
+    return QDBusMessageToIntArrayAsync(m);
 }
 
 /*!
@@ -836,8 +2006,18 @@ QList<int> Device::getMatrixDimensions()
  */
 int Device::getPollRate()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "getPollRate");
-    return QDBusMessageToInt(m);
+    return getPollRateAsync().value();
+}
+
+/*!
+ * \fn PendingReply<int> libopenrazer::Device::getPollRateAsync()
+ *
+ * Non-blocking variant of getPollRate().
+ */
+PendingReply<int> Device::getPollRateAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::getPollRate(mObjectPath);
+    return QDBusMessageToIntAsync(m);
 }
 
 /*!
@@ -849,11 +2029,18 @@ int Device::getPollRate()
  */
 bool Device::setPollRate(PollRate pollrate)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc", "setPollRate");
-    QList<QVariant> args;
-    args.append(pollrate);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setPollRateAsync(pollrate).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setPollRateAsync(PollRate pollrate)
+ *
+ * Non-blocking variant of setPollRate().
+ */
+PendingReply<bool> Device::setPollRateAsync(PollRate pollrate)
+{
+    QDBusMessage m = proxy::razer::device::misc::setPollRate(mObjectPath, pollrate);
+    return sendSetterAsync(m, DeviceProperties::PollRate, int(pollrate));
 }
 
 /*!
@@ -865,12 +2052,52 @@ bool Device::setPollRate(PollRate pollrate)
  */
 bool Device::setDPI(int dpi_x, int dpi_y)
 {
+    return !setDPIAsync(dpi_x, dpi_y).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setDPIAsync(int dpi_x, int dpi_y)
+ *
+ * Non-blocking variant of setDPI().
+ */
+PendingReply<bool> Device::setDPIAsync(int dpi_x, int dpi_y)
+{
+    // Not built with proxy::razer::device::dpi::setDPI(): its arguments are unsigned ('qq'), but the daemon takes -1 for dpi_y, sent as signed integers
     QDBusMessage m = prepareDeviceQDBusMessage("razer.device.dpi", "setDPI");
     QList<QVariant> args;
     args.append(dpi_x);
     args.append(dpi_y);
     m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    if(dpi_y == -1) {
+        // Y is left to the daemon, an invalid value forgets the DPI
+        return sendSetterAsync(m, DeviceProperties::DPI, QVariant());
+    }
+    return sendSetterAsync(m, DeviceProperties::DPI, QVariant::fromValue(QList<int>() << dpi_x << dpi_y));
+}
+
+/*!
+ * \fn void libopenrazer::Device::setDPIQueued(int dpi_x, int dpi_y)
+ *
+ * Like setDPI(), but sent through commandQueue(): while a previous call is still waiting for its reply, only the latest \a dpi_x and \a dpi_y get sent afterwards.
+ * Meant for values changing quickly, e.g. while dragging a slider.
+ */
+void Device::setDPIQueued(int dpi_x, int dpi_y)
+{
+    // Built by hand like in setDPIAsync()
+    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.dpi", "setDPI");
+    QList<QVariant> args;
+    args.append(dpi_x);
+    args.append(dpi_y);
+    m.setArguments(args);
+    if(dpi_y == -1) {
+        // Y is left to the daemon
+        commandQueue()->send(m);
+        invalidateProperty(DeviceProperties::DPI);
+    } else {
+        commandQueue()->send(m, refetchOnError(DeviceProperties::DPI));
+        // Updated right away, so the value follows a slider while it is dragged
+        updateProperty(DeviceProperties::DPI, QVariant::fromValue(QList<int>() << dpi_x << dpi_y));
+    }
 }
 
 /*!
@@ -880,8 +2107,18 @@ bool Device::setDPI(int dpi_x, int dpi_y)
  */
 QList<int> Device::getDPI()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.dpi", "getDPI");
-    return QDBusMessageToIntArray(m);
+    return getDPIAsync().value();
+}
+
+/*!
+ * \fn PendingReply<QList<int>> libopenrazer::Device::getDPIAsync()
+ *
+ * Non-blocking variant of getDPI().
+ */
+PendingReply<QList<int>> Device::getDPIAsync()
+{
+    QDBusMessage m = proxy::razer::device::dpi::getDPI(mObjectPath);
+    return QDBusMessageToIntArrayAsync(m);
 }
 
 /*!
@@ -891,8 +2128,18 @@ QList<int> Device::getDPI()
  */
 int Device::maxDPI()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.dpi", "maxDPI");
-    return QDBusMessageToInt(m);
+    return cachedValue("max_dpi", &Device::maxDPIAsync);
+}
+
+/*!
+ * \fn PendingReply<int> libopenrazer::Device::maxDPIAsync()
+ *
+ * Non-blocking variant of maxDPI().
+ */
+PendingReply<int> Device::maxDPIAsync()
+{
+    QDBusMessage m = proxy::razer::device::dpi::maxDPI(mObjectPath);
+    return QDBusMessageToIntAsync(m);
 }
 
 /*!
@@ -902,8 +2149,18 @@ int Device::maxDPI()
  */
 QList<int> Device::availableDPI()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.dpi", "availableDPI");
-    return QDBusMessageToIntArray(m);
+    return cachedValue("available_dpi", &Device::availableDPIAsync);
+}
+
+/*!
+ * \fn PendingReply<QList<int>> libopenrazer::Device::availableDPIAsync()
+ *
+ * Non-blocking variant of availableDPI().
+ */
+PendingReply<QList<int>> Device::availableDPIAsync()
+{
+    QDBusMessage m = proxy::razer::device::dpi::availableDPI(mObjectPath);
+    return QDBusMessageToIntArrayAsync(m);
 }
 
 // BATTERY
@@ -914,8 +2171,18 @@ QList<int> Device::availableDPI()
  */
 bool Device::isCharging()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.power", "isCharging");
-    return QDBusMessageToBool(m);
+    return isChargingAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::isChargingAsync()
+ *
+ * Non-blocking variant of isCharging().
+ */
+PendingReply<bool> Device::isChargingAsync()
+{
+    QDBusMessage m = proxy::razer::device::power::isCharging(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -925,8 +2192,18 @@ bool Device::isCharging()
  */
 double Device::getBatteryLevel()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.power", "getBattery");
-    return QDBusMessageToDouble(m);
+    return getBatteryLevelAsync().value();
+}
+
+/*!
+ * \fn PendingReply<double> libopenrazer::Device::getBatteryLevelAsync()
+ *
+ * Non-blocking variant of getBatteryLevel().
+ */
+PendingReply<double> Device::getBatteryLevelAsync()
+{
+    QDBusMessage m = proxy::razer::device::power::getBattery(mObjectPath);
+    return QDBusMessageToDoubleAsync(m);
 }
 
 /*!
@@ -939,11 +2216,18 @@ double Device::getBatteryLevel()
  */
 bool Device::setIdleTime(ushort idle_time)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.power", "setIdleTime");
-    QList<QVariant> args;
-    args.append(idle_time);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setIdleTimeAsync(idle_time).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setIdleTimeAsync(ushort idle_time)
+ *
+ * Non-blocking variant of setIdleTime().
+ */
+PendingReply<bool> Device::setIdleTimeAsync(ushort idle_time)
+{
+    QDBusMessage m = proxy::razer::device::power::setIdleTime(mObjectPath, idle_time);
+    return QDBusMessageToVoidAsync(m);
 }
 
 /*!
@@ -956,11 +2240,18 @@ bool Device::setIdleTime(ushort idle_time)
  */
 bool Device::setLowBatteryThreshold(uchar threshold)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.power", "setLowBatteryThreshold");
-    QList<QVariant> args;
-    args.append(threshold);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLowBatteryThresholdAsync(threshold).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLowBatteryThresholdAsync(uchar threshold)
+ *
+ * Non-blocking variant of setLowBatteryThreshold().
+ */
+PendingReply<bool> Device::setLowBatteryThresholdAsync(uchar threshold)
+{
+    QDBusMessage m = proxy::razer::device::power::setLowBatteryThreshold(mObjectPath, threshold);
+    return QDBusMessageToVoidAsync(m);
 }
 
 /*!
@@ -970,8 +2261,18 @@ bool Device::setLowBatteryThreshold(uchar threshold)
  */
 bool Device::isMugPresent()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.misc.mug", "isMugPresent");
-    return QDBusMessageToBool(m);
+    return isMugPresentAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::isMugPresentAsync()
+ *
+ * Non-blocking variant of isMugPresent().
+ */
+PendingReply<bool> Device::isMugPresentAsync()
+{
+    QDBusMessage m = proxy::razer::device::misc::mug::isMugPresent(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 // ------ LIGHTING EFFECTS ------
@@ -985,13 +2286,18 @@ bool Device::isMugPresent()
  */
 bool Device::setStatic(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setStatic");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setStaticAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setStaticAsync(QColor color)
+ *
+ * Non-blocking variant of setStatic().
+ */
+PendingReply<bool> Device::setStaticAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setStatic(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1003,13 +2309,18 @@ bool Device::setStatic(QColor color)
  */
 bool Device::setBreathSingle(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setBreathSingle");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBreathSingleAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBreathSingleAsync(QColor color)
+ *
+ * Non-blocking variant of setBreathSingle().
+ */
+PendingReply<bool> Device::setBreathSingleAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setBreathSingle(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1021,16 +2332,18 @@ bool Device::setBreathSingle(QColor color)
  */
 bool Device::setBreathDual(QColor color, QColor color2)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setBreathDual");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(color2.red());
-    args.append(color2.green());
-    args.append(color2.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBreathDualAsync(color, color2).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBreathDualAsync(QColor color, QColor color2)
+ *
+ * Non-blocking variant of setBreathDual().
+ */
+PendingReply<bool> Device::setBreathDualAsync(QColor color, QColor color2)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setBreathDual(mObjectPath, color.red(), color.green(), color.blue(), color2.red(), color2.green(), color2.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1042,19 +2355,18 @@ bool Device::setBreathDual(QColor color, QColor color2)
  */
 bool Device::setBreathTriple(QColor color, QColor color2, QColor color3)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setBreathTriple");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(color2.red());
-    args.append(color2.green());
-    args.append(color2.blue());
-    args.append(color3.red());
-    args.append(color3.green());
-    args.append(color3.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBreathTripleAsync(color, color2, color3).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBreathTripleAsync(QColor color, QColor color2, QColor color3)
+ *
+ * Non-blocking variant of setBreathTriple().
+ */
+PendingReply<bool> Device::setBreathTripleAsync(QColor color, QColor color2, QColor color3)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setBreathTriple(mObjectPath, color.red(), color.green(), color.blue(), color2.red(), color2.green(), color2.blue(), color3.red(), color3.green(), color3.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1066,8 +2378,18 @@ bool Device::setBreathTriple(QColor color, QColor color2, QColor color3)
  */
 bool Device::setBreathRandom()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setBreathRandom");
-    return QDBusMessageToVoid(m);
+    return !setBreathRandomAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBreathRandomAsync()
+ *
+ * Non-blocking variant of setBreathRandom().
+ */
+PendingReply<bool> Device::setBreathRandomAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setBreathRandom(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1079,14 +2401,18 @@ bool Device::setBreathRandom()
  */
 bool Device::setReactive(QColor color, ReactiveSpeed speed)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setReactive");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(speed);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setReactiveAsync(color, speed).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setReactiveAsync(QColor color, ReactiveSpeed speed)
+ *
+ * Non-blocking variant of setReactive().
+ */
+PendingReply<bool> Device::setReactiveAsync(QColor color, ReactiveSpeed speed)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setReactive(mObjectPath, color.red(), color.green(), color.blue(), speed);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1098,8 +2424,18 @@ bool Device::setReactive(QColor color, ReactiveSpeed speed)
  */
 bool Device::setSpectrum()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setSpectrum");
-    return QDBusMessageToVoid(m);
+    return !setSpectrumAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setSpectrumAsync()
+ *
+ * Non-blocking variant of setSpectrum().
+ */
+PendingReply<bool> Device::setSpectrumAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setSpectrum(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1111,11 +2447,18 @@ bool Device::setSpectrum()
  */
 bool Device::setWave(WaveDirection direction)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setWave");
-    QList<QVariant> args;
-    args.append(direction);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setWaveAsync(direction).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setWaveAsync(WaveDirection direction)
+ *
+ * Non-blocking variant of setWave().
+ */
+PendingReply<bool> Device::setWaveAsync(WaveDirection direction)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setWave(mObjectPath, direction);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1127,8 +2470,18 @@ bool Device::setWave(WaveDirection direction)
  */
 bool Device::setNone()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setNone");
-    return QDBusMessageToVoid(m);
+    return !setNoneAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setNoneAsync()
+ *
+ * Non-blocking variant of setNone().
+ */
+PendingReply<bool> Device::setNoneAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setNone(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1136,18 +2489,22 @@ bool Device::setNone()
  *
  * Sets the lighting to starlight effect with the specified \a color and \a speed.
  *
- * Returns if the D-Bus call was successful.
+ * Returns if the D-Bus call was successful.
+ */
+bool Device::setStarlightSingle(QColor color, StarlightSpeed speed)
+{
+    return !setStarlightSingleAsync(color, speed).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setStarlightSingleAsync(QColor color, StarlightSpeed speed)
+ *
+ * Non-blocking variant of setStarlightSingle().
  */
-bool Device::setStarlightSingle(QColor color, StarlightSpeed speed)
+PendingReply<bool> Device::setStarlightSingleAsync(QColor color, StarlightSpeed speed)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setStarlightSingle");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(speed);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setStarlightSingle(mObjectPath, color.red(), color.green(), color.blue(), speed);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1159,17 +2516,18 @@ bool Device::setStarlightSingle(QColor color, StarlightSpeed speed)
  */
 bool Device::setStarlightDual(QColor color, QColor color2, StarlightSpeed speed)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setStarlightDual");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(color2.red());
-    args.append(color2.green());
-    args.append(color2.blue());
-    args.append(speed);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setStarlightDualAsync(color, color2, speed).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setStarlightDualAsync(QColor color, QColor color2, StarlightSpeed speed)
+ *
+ * Non-blocking variant of setStarlightDual().
+ */
+PendingReply<bool> Device::setStarlightDualAsync(QColor color, QColor color2, StarlightSpeed speed)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setStarlightDual(mObjectPath, color.red(), color.green(), color.blue(), color2.red(), color2.green(), color2.blue(), speed);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1181,11 +2539,18 @@ bool Device::setStarlightDual(QColor color, QColor color2, StarlightSpeed speed)
  */
 bool Device::setStarlightRandom(StarlightSpeed speed)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setStarlightRandom");
-    QList<QVariant> args;
-    args.append(speed);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setStarlightRandomAsync(speed).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setStarlightRandomAsync(StarlightSpeed speed)
+ *
+ * Non-blocking variant of setStarlightRandom().
+ */
+PendingReply<bool> Device::setStarlightRandomAsync(StarlightSpeed speed)
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setStarlightRandom(mObjectPath, speed);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1197,8 +2562,18 @@ bool Device::setStarlightRandom(StarlightSpeed speed)
  */
 bool Device::setStatic_bw2013()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.bw2013", "setStatic");
-    return QDBusMessageToVoid(m);
+    return !setStatic_bw2013Async().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setStatic_bw2013Async()
+ *
+ * Non-blocking variant of setStatic_bw2013().
+ */
+PendingReply<bool> Device::setStatic_bw2013Async()
+{
+    QDBusMessage m = proxy::razer::device::lighting::bw2013::setStatic(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1210,8 +2585,18 @@ bool Device::setStatic_bw2013()
  */
 bool Device::setPulsate()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.bw2013", "setPulsate");
-    return QDBusMessageToVoid(m);
+    return !setPulsateAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setPulsateAsync()
+ *
+ * Non-blocking variant of setPulsate().
+ */
+PendingReply<bool> Device::setPulsateAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::bw2013::setPulsate(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1221,8 +2606,18 @@ bool Device::setPulsate()
  */
 bool Device::getBacklightActive()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "getBacklightActive");
-    return QDBusMessageToBool(m);
+    return getBacklightActiveAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::getBacklightActiveAsync()
+ *
+ * Non-blocking variant of getBacklightActive().
+ */
+PendingReply<bool> Device::getBacklightActiveAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::getBacklightActive(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -1234,11 +2629,18 @@ bool Device::getBacklightActive()
  */
 bool Device::setBacklightActive(bool active)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "setBacklightActive");
-    QList<QVariant> args;
-    args.append(active);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBacklightActiveAsync(active).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBacklightActiveAsync(bool active)
+ *
+ * Non-blocking variant of setBacklightActive().
+ */
+PendingReply<bool> Device::setBacklightActiveAsync(bool active)
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::setBacklightActive(mObjectPath, active);
+    return sendSetterAsync(m, DeviceProperties::BacklightActive, active);
 }
 
 /*!
@@ -1248,8 +2650,18 @@ bool Device::setBacklightActive(bool active)
  */
 uchar Device::getBacklightEffect()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "getBacklightEffect");
-    return QDBusMessageToByte(m);
+    return getBacklightEffectAsync().value();
+}
+
+/*!
+ * \fn PendingReply<uchar> libopenrazer::Device::getBacklightEffectAsync()
+ *
+ * Non-blocking variant of getBacklightEffect().
+ */
+PendingReply<uchar> Device::getBacklightEffectAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::getBacklightEffect(mObjectPath);
+    return QDBusMessageToByteAsync(m);
 }
 
 /*!
@@ -1261,11 +2673,32 @@ uchar Device::getBacklightEffect()
  */
 bool Device::setBacklightBrightness(double brightness)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "setBacklightBrightness");
-    QList<QVariant> args;
-    args.append(brightness);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBacklightBrightnessAsync(brightness).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBacklightBrightnessAsync(double brightness)
+ *
+ * Non-blocking variant of setBacklightBrightness().
+ */
+PendingReply<bool> Device::setBacklightBrightnessAsync(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::setBacklightBrightness(mObjectPath, brightness);
+    return sendSetterAsync(m, DeviceProperties::BacklightBrightness, brightness);
+}
+
+/*!
+ * \fn void libopenrazer::Device::setBacklightBrightnessQueued(double brightness)
+ *
+ * Like setBacklightBrightness(), but sent through commandQueue(): while a previous call is still waiting for its reply, only the latest \a brightness gets sent afterwards.
+ * Meant for values changing quickly, e.g. while dragging a slider.
+ */
+void Device::setBacklightBrightnessQueued(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::setBacklightBrightness(mObjectPath, brightness);
+    commandQueue()->send(m, refetchOnError(DeviceProperties::BacklightBrightness));
+    // Updated right away, so the value follows a slider while it is dragged
+    updateProperty(DeviceProperties::BacklightBrightness, brightness);
 }
 
 /*!
@@ -1275,8 +2708,18 @@ bool Device::setBacklightBrightness(double brightness)
  */
 double Device::getBacklightBrightness()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "getBacklightBrightness");
-    return QDBusMessageToDouble(m);
+    return getBacklightBrightnessAsync().value();
+}
+
+/*!
+ * \fn PendingReply<double> libopenrazer::Device::getBacklightBrightnessAsync()
+ *
+ * Non-blocking variant of getBacklightBrightness().
+ */
+PendingReply<double> Device::getBacklightBrightnessAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::getBacklightBrightness(mObjectPath);
+    return QDBusMessageToDoubleAsync(m);
 }
 
 /*!
@@ -1288,13 +2731,18 @@ double Device::getBacklightBrightness()
  */
 bool Device::setBacklightStatic(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "setBacklightStatic");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBacklightStaticAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBacklightStaticAsync(QColor color)
+ *
+ * Non-blocking variant of setBacklightStatic().
+ */
+PendingReply<bool> Device::setBacklightStaticAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::setBacklightStatic(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1306,8 +2754,18 @@ bool Device::setBacklightStatic(QColor color)
  */
 bool Device::setBacklightSpectrum()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.backlight", "setBacklightSpectrum");
-    return QDBusMessageToVoid(m);
+    return !setBacklightSpectrumAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBacklightSpectrumAsync()
+ *
+ * Non-blocking variant of setBacklightSpectrum().
+ */
+PendingReply<bool> Device::setBacklightSpectrumAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::backlight::setBacklightSpectrum(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1321,8 +2779,18 @@ bool Device::setBacklightSpectrum()
  */
 bool Device::setCustom()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setCustom");
-    return QDBusMessageToVoid(m);
+    return !setCustomAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setCustomAsync()
+ *
+ * Non-blocking variant of setCustom().
+ */
+PendingReply<bool> Device::setCustomAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setCustom(mObjectPath);
+    return QDBusMessageToVoidAsync(m);
 }
 
 /*!
@@ -1338,30 +2806,218 @@ bool Device::setCustom()
  * \sa setCustom()
  */
 bool Device::setKeyRow(uchar row, uchar startcol, uchar endcol, QVector<QColor> colors)
+{
+    return !setKeyRowAsync(row, startcol, endcol, colors).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setKeyRowAsync(uchar row, uchar startcol, uchar endcol, QVector<QColor> colors)
+ *
+ * Non-blocking variant of setKeyRow().
+ */
+PendingReply<bool> Device::setKeyRowAsync(uchar row, uchar startcol, uchar endcol, QVector<QColor> colors)
 {
     if(colors.count() != (endcol+1)-startcol) {
         qWarning() << "Invalid 'colors' length. startcol:" << startcol << " - endcol:" << endcol << " needs " << (endcol+1)-startcol << " entries in colors!";
-        return false;
+        QDBusMessage error = QDBusMessage::createError(QDBusError::InvalidArgs, "Invalid 'colors' length");
+        return PendingReply<bool>(QDBusPendingCall::fromError(error), replyToVoid);
     }
 
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.chroma", "setKeyRow");
+    // The row isn't known to the frame encoder anymore
+    invalidateMatrixFrame();
 
-    QByteArray parameters;
-    parameters[0] = row;
-    parameters[1] = startcol;
-    parameters[2] = endcol;
-    int counter = 3;
-    foreach(QColor c, colors) {
+    QByteArray parameters(3 + colors.size()*3, Qt::Uninitialized);
+    uchar *data = reinterpret_cast<uchar*>(parameters.data());
+    *data++ = row;
+    *data++ = startcol;
+    *data++ = endcol;
+    foreach(const QColor &c, colors) {
         // set the rgb to the parameters[i]
-        parameters[counter++] = c.red();
-        parameters[counter++] = c.green();
-        parameters[counter++] = c.blue();
+        QRgb rgb = c.rgb();
+        *data++ = qRed(rgb);
+        *data++ = qGreen(rgb);
+        *data++ = qBlue(rgb);
     }
 
-    QList<QVariant> args;
-    args.append(parameters);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setKeyRow(mObjectPath, parameters);
+    return QDBusMessageToVoidAsync(m);
+}
+
+/*!
+ * \fn bool libopenrazer::Device::setMatrixFrame(const QVector<QVector<QColor>> &frame, bool custom)
+ *
+ * Sets the lighting of the whole matrix to the colors in \a frame, one \c QVector<QColor> per row, each row starting at column 0.
+ * All rows are packed into a single setKeyRow payload, so the frame is sent with one D-Bus message instead of one per row.
+ * Only the rows that changed since the last frame are sent, a frame identical to the last one isn't sent at all.
+ * If \a custom is \c true, setCustom() is called afterwards so the frame gets displayed.
+ *
+ * Returns if the D-Bus call was successful.
+ *
+ * \sa setKeyRow(), setCustom()
+ */
+bool Device::setMatrixFrame(const QVector<QVector<QColor>> &frame, bool custom)
+{
+    return !setMatrixFrameAsync(frame, custom).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setMatrixFrameAsync(const QVector<QVector<QColor>> &frame, bool custom)
+ *
+ * Non-blocking variant of setMatrixFrame(). The reply is the one of the last message sent, which the daemon only answers after it has handled the ones before.
+ */
+PendingReply<bool> Device::setMatrixFrameAsync(const QVector<QVector<QColor>> &frame, bool custom)
+{
+    int rows = frame.size();
+    int columns = rows == 0 ? 0 : frame[0].size();
+
+    QMutexLocker locker(&frameMutex);
+
+    // Convert the colors into one contiguous RGB buffer, reusing the memory of the previous frame
+    frameBuffer.resize(rows * columns * 3);
+    uchar *data = reinterpret_cast<uchar*>(frameBuffer.data());
+    for(int i=0; i<rows; i++) {
+        const QVector<QColor> &colors = frame[i];
+        if(colors.size() != columns) {
+            qWarning() << "Invalid 'frame' row length. Row" << i << "has" << colors.size() << "entries but needs" << columns << "entries!";
+            QDBusMessage error = QDBusMessage::createError(QDBusError::InvalidArgs, "Invalid 'frame' row length");
+            return PendingReply<bool>(QDBusPendingCall::fromError(error), replyToVoid);
+        }
+        for(int j=0; j<columns; j++) {
+            QRgb rgb = colors[j].rgb();
+            *data++ = qRed(rgb);
+            *data++ = qGreen(rgb);
+            *data++ = qBlue(rgb);
+        }
+    }
+    return sendMatrixFrame(reinterpret_cast<const uchar*>(frameBuffer.constData()), rows, columns, FrameEncoder::RGB888, custom);
+}
+
+/*!
+ * \fn bool libopenrazer::Device::setMatrixFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom)
+ *
+ * Sets the lighting of the whole matrix to the frame in \a pixels, a contiguous buffer of \a rows * \a columns pixels in the given \a format.
+ * The payload is encoded with a FrameEncoder owned by the device, so streaming frames of the same size doesn't allocate a new payload for every frame.
+ * Only the rows that changed since the last frame are sent, a frame identical to the last one isn't sent at all.
+ * If \a custom is \c true, setCustom() is called afterwards so the frame gets displayed.
+ *
+ * Returns if the D-Bus call was successful.
+ *
+ * \sa setCustom(), FrameEncoder
+ */
+bool Device::setMatrixFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom)
+{
+    return !setMatrixFrameAsync(pixels, rows, columns, format, custom).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setMatrixFrameAsync(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom)
+ *
+ * Non-blocking variant of setMatrixFrame(). The reply is the one of the last message sent, which the daemon only answers after it has handled the ones before.
+ * It fails if any of the messages of the frame failed. A failed message makes the next frame get sent completely.
+ */
+PendingReply<bool> Device::setMatrixFrameAsync(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom)
+{
+    QMutexLocker locker(&frameMutex);
+    return sendMatrixFrame(pixels, rows, columns, format, custom);
+}
+
+/**
+ * Encodes the frame and sends the rows that changed. frameMutex has to be locked.
+ */
+PendingReply<bool> Device::sendMatrixFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom)
+{
+    CapturedCalls *captured = capturedCalls();
+    if(captured != NULL && !captured->isSentRightAway()) {
+        // The encoder would remember the frame as sent, see DeviceBatch
+        qWarning() << "Matrix frames can't be added to a DeviceBatch.";
+        QDBusMessage error = QDBusMessage::createError(QDBusError::NotSupported, "Matrix frames can't be batched");
+        return PendingReply<bool>(QDBusPendingCall::fromError(error), replyToVoid);
+    }
+
+    // Rows of a failed call are unknown now. Dropping the finished calls also releases their payload buffers for the encoder.
+    QList<QDBusPendingCall>::iterator it = frameCalls.begin();
+    while(it != frameCalls.end()) {
+        if(!it->isFinished()) {
+            ++it;
+            continue;
+        }
+        if(it->isError()) {
+            frameEncoder.invalidate();
+            matrixCustomApplied = false;
+        }
+        it = frameCalls.erase(it);
+    }
+
+    frameEncoder.resize(rows, columns);
+    const QByteArray &payload = frameEncoder.encodeChanged(pixels, format);
+
+    QDBusMessage customMessage = proxy::razer::device::lighting::chroma::setCustom(mObjectPath);
+    if(payload.isEmpty()) {
+        // Same frame as last time, nothing to send
+        if(!custom || matrixCustomApplied) {
+            return PendingReply<bool>(QDBusPendingCall::fromCompletedCall(customMessage.createReply()), replyToVoid);
+        }
+        matrixCustomApplied = true;
+        return PendingReply<bool>(sendFrameCall(customMessage), replyToVoid, customMessage);
+    }
+
+    QDBusMessage m = proxy::razer::device::lighting::chroma::setKeyRow(mObjectPath, payload);
+    QDBusPendingCall keyRowCall = sendFrameCall(m);
+    if(!custom) {
+        // The new rows only get displayed with the next setCustom
+        matrixCustomApplied = false;
+        return PendingReply<bool>(keyRowCall, replyToVoid, m);
+    }
+    matrixCustomApplied = true;
+    PendingReply<bool> reply(sendFrameCall(customMessage), replyToVoid, customMessage);
+    return reply.after(keyRowCall, m);
+}
+
+/**
+ * Sends a message of a frame and keeps track of its reply. frameMutex has to be locked.
+ * When the call is captured, e.g. by FrameStream, its reply handler invalidates the frame on errors instead.
+ */
+QDBusPendingCall Device::sendFrameCall(const QDBusMessage &m)
+{
+    CapturedCalls *captured = capturedCalls();
+    if(captured != NULL) {
+        captured->append(m, [this](const QDBusMessage &reply) {
+            if(reply.type() == QDBusMessage::ErrorMessage) {
+                invalidateMatrixFrame();
+            }
+        });
+        return QDBusPendingCall::fromCompletedCall(m.createReply());
+    }
+    QDBusPendingCall call = QDBusMessageToPendingCall(m);
+    frameCalls.append(call);
+    return call;
+}
+
+/*!
+ * \fn void libopenrazer::Device::invalidateMatrixFrame()
+ *
+ * Forgets the last frame sent with setMatrixFrame(), so the next frame gets sent completely.
+ * Lighting effects set through this object and failed frames do that automatically. Call it if the lighting might have been changed by someone else.
+ */
+void Device::invalidateMatrixFrame()
+{
+    QMutexLocker locker(&frameMutex);
+    frameEncoder.invalidate();
+    matrixCustomApplied = false;
+}
+
+/*!
+ * \fn void libopenrazer::Device::setMatrixFrameWindow(int frames)
+ *
+ * Tells the device that up to \a frames frames sent with setMatrixFrameAsync() can wait for their reply at the same time.
+ * The frame encoder keeps a payload buffer for each of them, so encoding the next frame doesn't have to allocate while they are in flight.
+ *
+ * \sa FrameEncoder::setBufferCount(), FrameStream
+ */
+void Device::setMatrixFrameWindow(int frames)
+{
+    QMutexLocker locker(&frameMutex);
+    frameEncoder.setBufferCount(frames + 1);
 }
 
 /*!
@@ -1374,14 +3030,18 @@ bool Device::setKeyRow(uchar row, uchar startcol, uchar endcol, QVector<QColor>
  */
 bool Device::setRipple(QColor color, double refresh_rate)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.custom", "setRipple");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(refresh_rate);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setRippleAsync(color, refresh_rate).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setRippleAsync(QColor color, double refresh_rate)
+ *
+ * Non-blocking variant of setRipple().
+ */
+PendingReply<bool> Device::setRippleAsync(QColor color, double refresh_rate)
+{
+    QDBusMessage m = proxy::razer::device::lighting::custom::setRipple(mObjectPath, color.red(), color.green(), color.blue(), refresh_rate);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1394,11 +3054,18 @@ bool Device::setRipple(QColor color, double refresh_rate)
  */
 bool Device::setRippleRandomColor(double refresh_rate)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.custom", "setRippleRandomColour");
-    QList<QVariant> args;
-    args.append(refresh_rate);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setRippleRandomColorAsync(refresh_rate).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setRippleRandomColorAsync(double refresh_rate)
+ *
+ * Non-blocking variant of setRippleRandomColor().
+ */
+PendingReply<bool> Device::setRippleRandomColorAsync(double refresh_rate)
+{
+    QDBusMessage m = proxy::razer::device::lighting::custom::setRippleRandomColour(mObjectPath, refresh_rate);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1410,11 +3077,32 @@ bool Device::setRippleRandomColor(double refresh_rate)
  */
 bool Device::setBrightness(double brightness)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.brightness", "setBrightness");
-    QList<QVariant> args;
-    args.append(brightness);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBrightnessAsync(brightness).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBrightnessAsync(double brightness)
+ *
+ * Non-blocking variant of setBrightness().
+ */
+PendingReply<bool> Device::setBrightnessAsync(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::brightness::setBrightness(mObjectPath, brightness);
+    return sendSetterAsync(m, DeviceProperties::Brightness, brightness);
+}
+
+/*!
+ * \fn void libopenrazer::Device::setBrightnessQueued(double brightness)
+ *
+ * Like setBrightness(), but sent through commandQueue(): while a previous call is still waiting for its reply, only the latest \a brightness gets sent afterwards.
+ * Meant for values changing quickly, e.g. while dragging a slider.
+ */
+void Device::setBrightnessQueued(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::brightness::setBrightness(mObjectPath, brightness);
+    commandQueue()->send(m, refetchOnError(DeviceProperties::Brightness));
+    // Updated right away, so the value follows a slider while it is dragged
+    updateProperty(DeviceProperties::Brightness, brightness);
 }
 
 /*!
@@ -1424,8 +3112,18 @@ bool Device::setBrightness(double brightness)
  */
 double Device::getBrightness()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.brightness", "getBrightness");
-    return QDBusMessageToDouble(m);
+    return getBrightnessAsync().value();
+}
+
+/*!
+ * \fn PendingReply<double> libopenrazer::Device::getBrightnessAsync()
+ *
+ * Non-blocking variant of getBrightness().
+ */
+PendingReply<double> Device::getBrightnessAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::brightness::getBrightness(mObjectPath);
+    return QDBusMessageToDoubleAsync(m);
 }
 
 /*!
@@ -1437,13 +3135,18 @@ double Device::getBrightness()
  */
 bool Device::setLogoStatic(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoStatic");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoStaticAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoStaticAsync(QColor color)
+ *
+ * Non-blocking variant of setLogoStatic().
+ */
+PendingReply<bool> Device::setLogoStaticAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoStatic(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1455,11 +3158,18 @@ bool Device::setLogoStatic(QColor color)
  */
 bool Device::setLogoActive(bool active)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoActive");
-    QList<QVariant> args;
-    args.append(active);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoActiveAsync(active).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoActiveAsync(bool active)
+ *
+ * Non-blocking variant of setLogoActive().
+ */
+PendingReply<bool> Device::setLogoActiveAsync(bool active)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoActive(mObjectPath, active);
+    return sendSetterAsync(m, DeviceProperties::LogoActive, active);
 }
 
 /*!
@@ -1469,19 +3179,39 @@ bool Device::setLogoActive(bool active)
  */
 bool Device::getLogoActive()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "getLogoActive");
-    return QDBusMessageToBool(m);
+    return getLogoActiveAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::getLogoActiveAsync()
+ *
+ * Non-blocking variant of getLogoActive().
+ */
+PendingReply<bool> Device::getLogoActiveAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::getLogoActive(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
+}
+
+/*!
+ * \fn uchar libopenrazer::Device::getLogoEffect()
+ *
+ * Returns the current effect on the logo LED. Values are defined in LEDEffect.
+ */
+uchar Device::getLogoEffect()
+{
+    return getLogoEffectAsync().value();
 }
 
 /*!
- * \fn uchar libopenrazer::Device::getLogoEffect()
+ * \fn PendingReply<uchar> libopenrazer::Device::getLogoEffectAsync()
  *
- * Returns the current effect on the logo LED. Values are defined in LEDEffect.
+ * Non-blocking variant of getLogoEffect().
  */
-uchar Device::getLogoEffect()
+PendingReply<uchar> Device::getLogoEffectAsync()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "getLogoEffect");
-    return QDBusMessageToByte(m);
+    QDBusMessage m = proxy::razer::device::lighting::logo::getLogoEffect(mObjectPath);
+    return QDBusMessageToByteAsync(m);
 }
 
 /*!
@@ -1493,13 +3223,18 @@ uchar Device::getLogoEffect()
  */
 bool Device::setLogoBlinking(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoBlinking");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoBlinkingAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoBlinkingAsync(QColor color)
+ *
+ * Non-blocking variant of setLogoBlinking().
+ */
+PendingReply<bool> Device::setLogoBlinkingAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoBlinking(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1511,13 +3246,18 @@ bool Device::setLogoBlinking(QColor color)
  */
 bool Device::setLogoPulsate(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoPulsate");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoPulsateAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoPulsateAsync(QColor color)
+ *
+ * Non-blocking variant of setLogoPulsate().
+ */
+PendingReply<bool> Device::setLogoPulsateAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoPulsate(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1529,8 +3269,18 @@ bool Device::setLogoPulsate(QColor color)
  */
 bool Device::setLogoSpectrum()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoSpectrum");
-    return QDBusMessageToVoid(m);
+    return !setLogoSpectrumAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoSpectrumAsync()
+ *
+ * Non-blocking variant of setLogoSpectrum().
+ */
+PendingReply<bool> Device::setLogoSpectrumAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoSpectrum(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1542,8 +3292,18 @@ bool Device::setLogoSpectrum()
  */
 bool Device::setLogoNone()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoNone");
-    return QDBusMessageToVoid(m);
+    return !setLogoNoneAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoNoneAsync()
+ *
+ * Non-blocking variant of setLogoNone().
+ */
+PendingReply<bool> Device::setLogoNoneAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoNone(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1555,14 +3315,18 @@ bool Device::setLogoNone()
  */
 bool Device::setLogoReactive(QColor color, ReactiveSpeed speed)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoReactive");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(speed);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoReactiveAsync(color, speed).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoReactiveAsync(QColor color, ReactiveSpeed speed)
+ *
+ * Non-blocking variant of setLogoReactive().
+ */
+PendingReply<bool> Device::setLogoReactiveAsync(QColor color, ReactiveSpeed speed)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoReactive(mObjectPath, color.red(), color.green(), color.blue(), speed);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1574,13 +3338,18 @@ bool Device::setLogoReactive(QColor color, ReactiveSpeed speed)
  */
 bool Device::setLogoBreathSingle(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoBreathSingle");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoBreathSingleAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoBreathSingleAsync(QColor color)
+ *
+ * Non-blocking variant of setLogoBreathSingle().
+ */
+PendingReply<bool> Device::setLogoBreathSingleAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoBreathSingle(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1592,16 +3361,18 @@ bool Device::setLogoBreathSingle(QColor color)
  */
 bool Device::setLogoBreathDual(QColor color, QColor color2)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoBreathDual");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(color2.red());
-    args.append(color2.green());
-    args.append(color2.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoBreathDualAsync(color, color2).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoBreathDualAsync(QColor color, QColor color2)
+ *
+ * Non-blocking variant of setLogoBreathDual().
+ */
+PendingReply<bool> Device::setLogoBreathDualAsync(QColor color, QColor color2)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoBreathDual(mObjectPath, color.red(), color.green(), color.blue(), color2.red(), color2.green(), color2.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1613,8 +3384,18 @@ bool Device::setLogoBreathDual(QColor color, QColor color2)
  */
 bool Device::setLogoBreathRandom()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoBreathRandom");
-    return QDBusMessageToVoid(m);
+    return !setLogoBreathRandomAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoBreathRandomAsync()
+ *
+ * Non-blocking variant of setLogoBreathRandom().
+ */
+PendingReply<bool> Device::setLogoBreathRandomAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoBreathRandom(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1626,11 +3407,32 @@ bool Device::setLogoBreathRandom()
  */
 bool Device::setLogoBrightness(double brightness)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "setLogoBrightness");
-    QList<QVariant> args;
-    args.append(brightness);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setLogoBrightnessAsync(brightness).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setLogoBrightnessAsync(double brightness)
+ *
+ * Non-blocking variant of setLogoBrightness().
+ */
+PendingReply<bool> Device::setLogoBrightnessAsync(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoBrightness(mObjectPath, brightness);
+    return sendSetterAsync(m, DeviceProperties::LogoBrightness, brightness);
+}
+
+/*!
+ * \fn void libopenrazer::Device::setLogoBrightnessQueued(double brightness)
+ *
+ * Like setLogoBrightness(), but sent through commandQueue(): while a previous call is still waiting for its reply, only the latest \a brightness gets sent afterwards.
+ * Meant for values changing quickly, e.g. while dragging a slider.
+ */
+void Device::setLogoBrightnessQueued(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::setLogoBrightness(mObjectPath, brightness);
+    commandQueue()->send(m, refetchOnError(DeviceProperties::LogoBrightness));
+    // Updated right away, so the value follows a slider while it is dragged
+    updateProperty(DeviceProperties::LogoBrightness, brightness);
 }
 
 /*!
@@ -1640,8 +3442,18 @@ bool Device::setLogoBrightness(double brightness)
  */
 double Device::getLogoBrightness()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.logo", "getLogoBrightness");
-    return QDBusMessageToDouble(m);
+    return getLogoBrightnessAsync().value();
+}
+
+/*!
+ * \fn PendingReply<double> libopenrazer::Device::getLogoBrightnessAsync()
+ *
+ * Non-blocking variant of getLogoBrightness().
+ */
+PendingReply<double> Device::getLogoBrightnessAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::logo::getLogoBrightness(mObjectPath);
+    return QDBusMessageToDoubleAsync(m);
 }
 
 /*!
@@ -1653,13 +3465,18 @@ double Device::getLogoBrightness()
  */
 bool Device::setScrollStatic(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollStatic");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollStaticAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollStaticAsync(QColor color)
+ *
+ * Non-blocking variant of setScrollStatic().
+ */
+PendingReply<bool> Device::setScrollStaticAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollStatic(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1671,11 +3488,18 @@ bool Device::setScrollStatic(QColor color)
  */
 bool Device::setScrollActive(bool active)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollActive");
-    QList<QVariant> args;
-    args.append(active);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollActiveAsync(active).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollActiveAsync(bool active)
+ *
+ * Non-blocking variant of setScrollActive().
+ */
+PendingReply<bool> Device::setScrollActiveAsync(bool active)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollActive(mObjectPath, active);
+    return sendSetterAsync(m, DeviceProperties::ScrollActive, active);
 }
 
 /*!
@@ -1685,8 +3509,18 @@ bool Device::setScrollActive(bool active)
  */
 bool Device::getScrollActive()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "getScrollActive");
-    return QDBusMessageToBool(m);
+    return getScrollActiveAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::getScrollActiveAsync()
+ *
+ * Non-blocking variant of getScrollActive().
+ */
+PendingReply<bool> Device::getScrollActiveAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::getScrollActive(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -1696,8 +3530,18 @@ bool Device::getScrollActive()
  */
 uchar Device::getScrollEffect()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "getScrollEffect");
-    return QDBusMessageToByte(m);
+    return getScrollEffectAsync().value();
+}
+
+/*!
+ * \fn PendingReply<uchar> libopenrazer::Device::getScrollEffectAsync()
+ *
+ * Non-blocking variant of getScrollEffect().
+ */
+PendingReply<uchar> Device::getScrollEffectAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::getScrollEffect(mObjectPath);
+    return QDBusMessageToByteAsync(m);
 }
 
 /*!
@@ -1709,13 +3553,18 @@ uchar Device::getScrollEffect()
  */
 bool Device::setScrollBlinking(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollBlinking");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollBlinkingAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollBlinkingAsync(QColor color)
+ *
+ * Non-blocking variant of setScrollBlinking().
+ */
+PendingReply<bool> Device::setScrollBlinkingAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollBlinking(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1727,13 +3576,18 @@ bool Device::setScrollBlinking(QColor color)
  */
 bool Device::setScrollPulsate(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollPulsate");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollPulsateAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollPulsateAsync(QColor color)
+ *
+ * Non-blocking variant of setScrollPulsate().
+ */
+PendingReply<bool> Device::setScrollPulsateAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollPulsate(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1745,8 +3599,18 @@ bool Device::setScrollPulsate(QColor color)
  */
 bool Device::setScrollSpectrum()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollSpectrum");
-    return QDBusMessageToVoid(m);
+    return !setScrollSpectrumAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollSpectrumAsync()
+ *
+ * Non-blocking variant of setScrollSpectrum().
+ */
+PendingReply<bool> Device::setScrollSpectrumAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollSpectrum(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1758,8 +3622,18 @@ bool Device::setScrollSpectrum()
  */
 bool Device::setScrollNone()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollNone");
-    return QDBusMessageToVoid(m);
+    return !setScrollNoneAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollNoneAsync()
+ *
+ * Non-blocking variant of setScrollNone().
+ */
+PendingReply<bool> Device::setScrollNoneAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollNone(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1771,14 +3645,18 @@ bool Device::setScrollNone()
  */
 bool Device::setScrollReactive(QColor color, ReactiveSpeed speed)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollReactive");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(speed);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollReactiveAsync(color, speed).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollReactiveAsync(QColor color, ReactiveSpeed speed)
+ *
+ * Non-blocking variant of setScrollReactive().
+ */
+PendingReply<bool> Device::setScrollReactiveAsync(QColor color, ReactiveSpeed speed)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollReactive(mObjectPath, color.red(), color.green(), color.blue(), speed);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1790,13 +3668,18 @@ bool Device::setScrollReactive(QColor color, ReactiveSpeed speed)
  */
 bool Device::setScrollBreathSingle(QColor color)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollBreathSingle");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollBreathSingleAsync(color).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollBreathSingleAsync(QColor color)
+ *
+ * Non-blocking variant of setScrollBreathSingle().
+ */
+PendingReply<bool> Device::setScrollBreathSingleAsync(QColor color)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollBreathSingle(mObjectPath, color.red(), color.green(), color.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1808,16 +3691,18 @@ bool Device::setScrollBreathSingle(QColor color)
  */
 bool Device::setScrollBreathDual(QColor color, QColor color2)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollBreathDual");
-    QList<QVariant> args;
-    args.append(color.red());
-    args.append(color.green());
-    args.append(color.blue());
-    args.append(color2.red());
-    args.append(color2.green());
-    args.append(color2.blue());
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollBreathDualAsync(color, color2).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollBreathDualAsync(QColor color, QColor color2)
+ *
+ * Non-blocking variant of setScrollBreathDual().
+ */
+PendingReply<bool> Device::setScrollBreathDualAsync(QColor color, QColor color2)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollBreathDual(mObjectPath, color.red(), color.green(), color.blue(), color2.red(), color2.green(), color2.blue());
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1829,8 +3714,18 @@ bool Device::setScrollBreathDual(QColor color, QColor color2)
  */
 bool Device::setScrollBreathRandom()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollBreathRandom");
-    return QDBusMessageToVoid(m);
+    return !setScrollBreathRandomAsync().isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollBreathRandomAsync()
+ *
+ * Non-blocking variant of setScrollBreathRandom().
+ */
+PendingReply<bool> Device::setScrollBreathRandomAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollBreathRandom(mObjectPath);
+    return sendEffectAsync(m);
 }
 
 /*!
@@ -1842,11 +3737,32 @@ bool Device::setScrollBreathRandom()
  */
 bool Device::setScrollBrightness(double brightness)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "setScrollBrightness");
-    QList<QVariant> args;
-    args.append(brightness);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setScrollBrightnessAsync(brightness).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setScrollBrightnessAsync(double brightness)
+ *
+ * Non-blocking variant of setScrollBrightness().
+ */
+PendingReply<bool> Device::setScrollBrightnessAsync(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollBrightness(mObjectPath, brightness);
+    return sendSetterAsync(m, DeviceProperties::ScrollBrightness, brightness);
+}
+
+/*!
+ * \fn void libopenrazer::Device::setScrollBrightnessQueued(double brightness)
+ *
+ * Like setScrollBrightness(), but sent through commandQueue(): while a previous call is still waiting for its reply, only the latest \a brightness gets sent afterwards.
+ * Meant for values changing quickly, e.g. while dragging a slider.
+ */
+void Device::setScrollBrightnessQueued(double brightness)
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::setScrollBrightness(mObjectPath, brightness);
+    commandQueue()->send(m, refetchOnError(DeviceProperties::ScrollBrightness));
+    // Updated right away, so the value follows a slider while it is dragged
+    updateProperty(DeviceProperties::ScrollBrightness, brightness);
 }
 
 /*!
@@ -1856,8 +3772,18 @@ bool Device::setScrollBrightness(double brightness)
  */
 double Device::getScrollBrightness()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.scroll", "getScrollBrightness");
-    return QDBusMessageToDouble(m);
+    return getScrollBrightnessAsync().value();
+}
+
+/*!
+ * \fn PendingReply<double> libopenrazer::Device::getScrollBrightnessAsync()
+ *
+ * Non-blocking variant of getScrollBrightness().
+ */
+PendingReply<double> Device::getScrollBrightnessAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::scroll::getScrollBrightness(mObjectPath);
+    return QDBusMessageToDoubleAsync(m);
 }
 
 /*!
@@ -1867,8 +3793,18 @@ double Device::getScrollBrightness()
  */
 bool Device::getBlueLED()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.profile_led", "getBlueLED");
-    return QDBusMessageToBool(m);
+    return getBlueLEDAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::getBlueLEDAsync()
+ *
+ * Non-blocking variant of getBlueLED().
+ */
+PendingReply<bool> Device::getBlueLEDAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::profile_led::getBlueLED(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -1880,11 +3816,18 @@ bool Device::getBlueLED()
  */
 bool Device::setBlueLED(bool on)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.profile_led", "setBlueLED");
-    QList<QVariant> args;
-    args.append(on);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setBlueLEDAsync(on).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setBlueLEDAsync(bool on)
+ *
+ * Non-blocking variant of setBlueLED().
+ */
+PendingReply<bool> Device::setBlueLEDAsync(bool on)
+{
+    QDBusMessage m = proxy::razer::device::lighting::profile_led::setBlueLED(mObjectPath, on);
+    return sendSetterAsync(m, DeviceProperties::BlueLED, on);
 }
 
 /*!
@@ -1894,8 +3837,18 @@ bool Device::setBlueLED(bool on)
  */
 bool Device::getGreenLED()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.profile_led", "getGreenLED");
-    return QDBusMessageToBool(m);
+    return getGreenLEDAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::getGreenLEDAsync()
+ *
+ * Non-blocking variant of getGreenLED().
+ */
+PendingReply<bool> Device::getGreenLEDAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::profile_led::getGreenLED(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -1907,11 +3860,18 @@ bool Device::getGreenLED()
  */
 bool Device::setGreenLED(bool on)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.profile_led", "setGreenLED");
-    QList<QVariant> args;
-    args.append(on);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setGreenLEDAsync(on).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setGreenLEDAsync(bool on)
+ *
+ * Non-blocking variant of setGreenLED().
+ */
+PendingReply<bool> Device::setGreenLEDAsync(bool on)
+{
+    QDBusMessage m = proxy::razer::device::lighting::profile_led::setGreenLED(mObjectPath, on);
+    return sendSetterAsync(m, DeviceProperties::GreenLED, on);
 }
 
 /*!
@@ -1921,8 +3881,18 @@ bool Device::setGreenLED(bool on)
  */
 bool Device::getRedLED()
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.profile_led", "getRedLED");
-    return QDBusMessageToBool(m);
+    return getRedLEDAsync().value();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::getRedLEDAsync()
+ *
+ * Non-blocking variant of getRedLED().
+ */
+PendingReply<bool> Device::getRedLEDAsync()
+{
+    QDBusMessage m = proxy::razer::device::lighting::profile_led::getRedLED(mObjectPath);
+    return QDBusMessageToBoolAsync(m);
 }
 
 /*!
@@ -1934,10 +3904,17 @@ bool Device::getRedLED()
  */
 bool Device::setRedLED(bool on)
 {
-    QDBusMessage m = prepareDeviceQDBusMessage("razer.device.lighting.profile_led", "setRedLED");
-    QList<QVariant> args;
-    args.append(on);
-    m.setArguments(args);
-    return QDBusMessageToVoid(m);
+    return !setRedLEDAsync(on).isError();
+}
+
+/*!
+ * \fn PendingReply<bool> libopenrazer::Device::setRedLEDAsync(bool on)
+ *
+ * Non-blocking variant of setRedLED().
+ */
+PendingReply<bool> Device::setRedLEDAsync(bool on)
+{
+    QDBusMessage m = proxy::razer::device::lighting::profile_led::setRedLED(mObjectPath, on);
+    return sendSetterAsync(m, DeviceProperties::RedLED, on);
 }
 }
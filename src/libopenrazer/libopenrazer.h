@@ -19,9 +19,23 @@
 #ifndef LIBRAZER_H
 #define LIBRAZER_H
 
-#include <QDomDocument>
+#include <bitset>
+#include <functional>
+
 #include <QDBusMessage>
-#include "razercapability.h"
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QVariantHash>
+#include "pendingreply.h"
+#include "frameencoder.h"
+#include "devicecache.h"
+#include "deviceproperties.h"
+#include "commandqueue.h"
+#include "iothread.h"
+#include "usbdevices.h"
 
 // NOTE: DBus types -> Qt/C++ types: http://doc.qt.io/qt-5/qdbustypesystem.html#primitive-types
 
@@ -50,218 +64,397 @@ enum PollRate { POLL_1000HZ = 1000, POLL_500HZ = 500, POLL_125HZ = 125 };
 
 enum DaemonStatus { Enabled, Disabled, NotInstalled, NoSystemd, Unknown };
 
-const static QList<RazerCapability> lightingComboBoxCapabilites {
-    RazerCapability("lighting_breath_single", "Breath Single", 1),
-    RazerCapability("lighting_breath_dual", "Breath Dual", 2),
-    RazerCapability("lighting_breath_triple", "Breath Triple", 3),
-    RazerCapability("lighting_breath_random", "Breath Random", 0),
-    RazerCapability("lighting_wave", "Wave", true),
-    RazerCapability("lighting_reactive", "Reactive", 1),
-    RazerCapability("lighting_none", "None", 0),
-    RazerCapability("lighting_spectrum", "Spectrum", 0),
-    RazerCapability("lighting_static", "Static", 1),
-    RazerCapability("lighting_ripple", "Ripple", 1), // Needs "refresh_rate"
-    RazerCapability("lighting_ripple_random", "Ripple random", 0), // Needs "refresh_rate"
-    RazerCapability("lighting_pulsate", "Pulsate", 0),
-    RazerCapability("lighting_static_bw2013", "Static", 0),
-};
-
-const static QList<RazerCapability> logoComboBoxCapabilites {
-    RazerCapability("lighting_logo_blinking", "Blinking", 1),
-    RazerCapability("lighting_logo_pulsate", "Pulsate", 1),
-    RazerCapability("lighting_logo_spectrum", "Spectrum", 0),
-    RazerCapability("lighting_logo_static", "Static", 1),
-    RazerCapability("lighting_logo_none", "None", 0),
-    RazerCapability("lighting_logo_reactive", "Reactive", 1),
-    RazerCapability("lighting_logo_breath_single", "Breath Single", 1),
-    RazerCapability("lighting_logo_breath_dual", "Breath Dual", 2),
-    RazerCapability("lighting_logo_breath_random", "Breath random", 0),
-};
-
-const static QList<RazerCapability> scrollComboBoxCapabilites {
-    RazerCapability("lighting_scroll_blinking", "Blinking", 1),
-    RazerCapability("lighting_scroll_pulsate", "Pulsate", 1),
-    RazerCapability("lighting_scroll_spectrum", "Spectrum", 0),
-    RazerCapability("lighting_scroll_static", "Static", 1),
-    RazerCapability("lighting_scroll_none", "None", 0),
-    RazerCapability("lighting_scroll_reactive", "Reactive", 1),
-    RazerCapability("lighting_scroll_breath_single", "Breath Single", 1),
-    RazerCapability("lighting_scroll_breath_dual", "Breath Dual", 2),
-    RazerCapability("lighting_scroll_breath_random", "Breath random", 0),
+// Capabilities, names are from the pylib. Generated with ./scripts/capabilities_to_cpp.sh enum
+enum Capability {
+    CAP_NAME,
+    CAP_TYPE,
+    CAP_FIRMWARE_VERSION,
+    CAP_SERIAL,
+    CAP_DPI,
+    CAP_AVAILABLE_DPI,
+    CAP_BRIGHTNESS,
+    CAP_GET_BRIGHTNESS,
+    CAP_BATTERY,
+    CAP_POLL_RATE,
+    CAP_MUG,
+    CAP_BACKLIGHT,
+    CAP_KBD_LAYOUT,
+    CAP_MACRO_LOGIC,
+    CAP_LIGHTING,
+    CAP_LIGHTING_BREATH_SINGLE,
+    CAP_LIGHTING_BREATH_DUAL,
+    CAP_LIGHTING_BREATH_TRIPLE,
+    CAP_LIGHTING_BREATH_RANDOM,
+    CAP_LIGHTING_CHARGING,
+    CAP_LIGHTING_WAVE,
+    CAP_LIGHTING_REACTIVE,
+    CAP_LIGHTING_NONE,
+    CAP_LIGHTING_SPECTRUM,
+    CAP_LIGHTING_STATIC,
+    CAP_LIGHTING_STARLIGHT_SINGLE,
+    CAP_LIGHTING_STARLIGHT_DUAL,
+    CAP_LIGHTING_STARLIGHT_RANDOM,
+    CAP_LIGHTING_RIPPLE,
+    CAP_LIGHTING_RIPPLE_RANDOM,
+    CAP_LIGHTING_BW2013,
+    CAP_LIGHTING_STATIC_BW2013,
+    CAP_LIGHTING_PULSATE,
+    CAP_LIGHTING_PROFILE_LEDS,
+    CAP_LIGHTING_LED_MATRIX,
+    CAP_LIGHTING_LED_SINGLE,
+    CAP_LIGHTING_LOGO,
+    CAP_LIGHTING_LOGO_ACTIVE,
+    CAP_LIGHTING_LOGO_BLINKING,
+    CAP_LIGHTING_LOGO_BRIGHTNESS,
+    CAP_GET_LIGHTING_LOGO_BRIGHTNESS,
+    CAP_LIGHTING_LOGO_PULSATE,
+    CAP_LIGHTING_LOGO_SPECTRUM,
+    CAP_LIGHTING_LOGO_STATIC,
+    CAP_LIGHTING_LOGO_NONE,
+    CAP_LIGHTING_LOGO_REACTIVE,
+    CAP_LIGHTING_LOGO_BREATH_SINGLE,
+    CAP_LIGHTING_LOGO_BREATH_DUAL,
+    CAP_LIGHTING_LOGO_BREATH_RANDOM,
+    CAP_LIGHTING_SCROLL,
+    CAP_LIGHTING_SCROLL_ACTIVE,
+    CAP_LIGHTING_SCROLL_BLINKING,
+    CAP_LIGHTING_SCROLL_BRIGHTNESS,
+    CAP_GET_LIGHTING_SCROLL_BRIGHTNESS,
+    CAP_LIGHTING_SCROLL_PULSATE,
+    CAP_LIGHTING_SCROLL_SPECTRUM,
+    CAP_LIGHTING_SCROLL_STATIC,
+    CAP_LIGHTING_SCROLL_NONE,
+    CAP_LIGHTING_SCROLL_REACTIVE,
+    CAP_LIGHTING_SCROLL_BREATH_SINGLE,
+    CAP_LIGHTING_SCROLL_BREATH_DUAL,
+    CAP_LIGHTING_SCROLL_BREATH_RANDOM,
+    CAP_LIGHTING_BACKLIGHT,
+    CAP_LIGHTING_BACKLIGHT_ACTIVE,
+    CAP_GET_LIGHTING_BACKLIGHT_EFFECT,
+    CAP_LIGHTING_BACKLIGHT_BRIGHTNESS,
+    CAP_GET_LIGHTING_BACKLIGHT_BRIGHTNESS,
+    CAP_LIGHTING_BACKLIGHT_SPECTRUM,
+    CAP_LIGHTING_BACKLIGHT_STATIC,
+    CAP_COUNT
 };
 
-const static QList<RazerCapability> backlightComboBoxCapabilites {
-    RazerCapability("lighting_backlight_spectrum", "Spectrum", 0),
-    RazerCapability("lighting_backlight_static", "Static", 1),
-};
+QString capabilityName(Capability capability);
 
 // Daemon controls
 QStringList getConnectedDevices();
+PendingReply<QStringList> getConnectedDevicesAsync();
 QString getDaemonVersion();
+PendingReply<QString> getDaemonVersionAsync();
 bool stopDaemon();
 bool isDaemonRunning();
+bool isDaemonRegistered();
 
 QVariantHash getSupportedDevices();
+PendingReply<QVariantHash> getSupportedDevicesAsync();
 
 // Sync
 bool syncEffects(bool yes);
+PendingReply<bool> syncEffectsAsync(bool yes);
 bool getSyncEffects();
+PendingReply<bool> getSyncEffectsAsync();
 
 // Screensaver
 bool setTurnOffOnScreensaver(bool turnOffOnScreensaver);
+PendingReply<bool> setTurnOffOnScreensaverAsync(bool turnOffOnScreensaver);
 bool getTurnOffOnScreensaver();
+PendingReply<bool> getTurnOffOnScreensaverAsync();
 
 // Misc
 DaemonStatus getDaemonStatus();
+PendingReply<DaemonStatus> getDaemonStatusAsync();
 QString getDaemonStatusOutput();
+PendingReply<QString> getDaemonStatusOutputAsync();
 bool enableDaemon();
+PendingReply<bool> enableDaemonAsync();
 // bool disableDaemon();
 
 // - Signal Connect Mehtods -
 bool connectDeviceAdded(QObject *receiver, const char *slot);
 bool connectDeviceRemoved(QObject *receiver, const char *slot);
 
+class DeviceBatch;
+
 class Device
 {
 private:
+    // Only written during construction
     QString mSerial;
-    QStringList introspection;
-    QHash<QString, bool> capabilities;
+    QString mObjectPath;
+    QHash<QString, QSet<QString>> introspection;
+    std::bitset<CAP_COUNT> capabilities;
+    DeviceCache *cache;
+
+    // Guarded by frameMutex
+    QMutex frameMutex;
+    FrameEncoder frameEncoder;
+    QByteArray frameBuffer;
+    bool matrixCustomApplied;
+    QList<QDBusPendingCall> frameCalls;
+
+    // Guarded by mutex
+    QMutex mutex;
+    QJsonObject metadata;
+    DeviceProperties *mProperties;
+    CommandQueue *mCommandQueue;
 
     QDBusMessage prepareDeviceQDBusMessage(const QString &interface, const QString &method);
+    Device(const QString &serial, DeviceCache *cache, bool setup);
     void Introspect();
+    void parseIntrospection(const QDBusMessage &reply);
     void setupCapabilities();
+    void finishSetup();
 
     bool hasCapabilityInternal(const QString &interface, const QString &method = QString());
+
+    bool loadFromCache();
+    bool checkCachedVidPid(const PendingReply<QList<int>> &reply);
+    void storeInCache();
+    template<typename T> T cachedValue(const QString &key, PendingReply<T> (Device::*call)());
+    void updateProperty(DeviceProperties::Property property, const QVariant &value);
+    void invalidateProperty(DeviceProperties::Property property);
+    PendingReply<bool> sendSetterAsync(const QDBusMessage &m, DeviceProperties::Property property, const QVariant &value);
+    CallCallback refetchOnError(DeviceProperties::Property property);
+    PendingReply<bool> sendEffectAsync(const QDBusMessage &m);
+    PendingReply<bool> sendMatrixFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom);
+    QDBusPendingCall sendFrameCall(const QDBusMessage &m);
+    template<typename T> void prefetchValue(QList<std::function<void()>> *finishers, const QString &key, PendingReply<T> (Device::*call)());
+    static QList<Device*> createDevices(const QStringList &serials, DeviceCache *cache, const std::function<void(Device*)> &ready);
 public:
-    Device(QString serial);
+    Device(QString serial, DeviceCache *cache = NULL);
     ~Device();
 
+    static QList<Device*> createDevices(const QStringList &serials, DeviceCache *cache = NULL);
+    static void createDevicesAsync(const QStringList &serials, DeviceCache *cache, QObject *context, const std::function<void(Device*)> &deviceReady, const std::function<void()> &finished = std::function<void()>());
+
     QString serial();
     bool hasCapability(const QString &name);
+    bool hasCapability(Capability capability);
     QHash<QString, bool> getAllCapabilities();
+    DeviceProperties *properties();
+    CommandQueue *commandQueue();
+    DeviceBatch batch();
     QString getPngFilename();
     QString getPngUrl();
 
     // --- MISC METHODS ---
     QString getDeviceMode();
+    PendingReply<QString> getDeviceModeAsync();
     bool setDeviceMode(uchar mode_id, uchar param);
+    PendingReply<bool> setDeviceModeAsync(uchar mode_id, uchar param);
     QString getDeviceName();
+    PendingReply<QString> getDeviceNameAsync();
     QString getDeviceType();
+    PendingReply<QString> getDeviceTypeAsync();
     QString getDriverVersion();
+    PendingReply<QString> getDriverVersionAsync();
     QString getFirmwareVersion();
+    PendingReply<QString> getFirmwareVersionAsync();
     QString getKeyboardLayout();
+    PendingReply<QString> getKeyboardLayoutAsync();
     QVariantHash getRazerUrls();
+    PendingReply<QVariantHash> getRazerUrlsAsync();
     // VID / PID
     int getVid();
     int getPid();
+    PendingReply<QList<int>> getVidPidAsync();
 
     // --- MACRO ---
     bool hasDedicatedMacroKeys();
+    PendingReply<bool> hasDedicatedMacroKeysAsync();
     //TODO Rest
 
     // --- MATRIX ---
     bool hasMatrix();
+    PendingReply<bool> hasMatrixAsync();
     QList<int> getMatrixDimensions();
+    PendingReply<QList<int>> getMatrixDimensionsAsync();
 
     // --- POLL RATE ---
     int getPollRate();
+    PendingReply<int> getPollRateAsync();
     bool setPollRate(PollRate pollrate);
+    PendingReply<bool> setPollRateAsync(PollRate pollrate);
 
     // --- DPI ---
     bool setDPI(int dpi_x, int dpi_y);
+    PendingReply<bool> setDPIAsync(int dpi_x, int dpi_y);
+    void setDPIQueued(int dpi_x, int dpi_y);
     QList<int> getDPI();
+    PendingReply<QList<int>> getDPIAsync();
     int maxDPI();
+    PendingReply<int> maxDPIAsync();
     QList<int> availableDPI();
+    PendingReply<QList<int>> availableDPIAsync();
 
     // --- BATTERY ----
     bool isCharging();
+    PendingReply<bool> isChargingAsync();
     double getBatteryLevel();
+    PendingReply<double> getBatteryLevelAsync();
     bool setIdleTime(ushort idle_time);
+    PendingReply<bool> setIdleTimeAsync(ushort idle_time);
     bool setLowBatteryThreshold(uchar threshold);
+    PendingReply<bool> setLowBatteryThresholdAsync(uchar threshold);
 
     // --- MUG ---
     bool isMugPresent();
+    PendingReply<bool> isMugPresentAsync();
 
     // --- LIGHTING EFFECTS ---
     // - Default -
     bool setStatic(QColor color);
+    PendingReply<bool> setStaticAsync(QColor color);
     bool setBreathSingle(QColor color);
+    PendingReply<bool> setBreathSingleAsync(QColor color);
     bool setBreathDual(QColor color, QColor color2);
+    PendingReply<bool> setBreathDualAsync(QColor color, QColor color2);
     bool setBreathTriple(QColor color, QColor color2, QColor color3);
+    PendingReply<bool> setBreathTripleAsync(QColor color, QColor color2, QColor color3);
     bool setBreathRandom();
+    PendingReply<bool> setBreathRandomAsync();
     bool setReactive(QColor color, ReactiveSpeed speed);
+    PendingReply<bool> setReactiveAsync(QColor color, ReactiveSpeed speed);
     bool setSpectrum();
+    PendingReply<bool> setSpectrumAsync();
     bool setWave(WaveDirection direction);
+    PendingReply<bool> setWaveAsync(WaveDirection direction);
     bool setNone();
+    PendingReply<bool> setNoneAsync();
     // Starlight
     bool setStarlightSingle(QColor color, StarlightSpeed speed);
+    PendingReply<bool> setStarlightSingleAsync(QColor color, StarlightSpeed speed);
     bool setStarlightDual(QColor color, QColor color2, StarlightSpeed speed);
+    PendingReply<bool> setStarlightDualAsync(QColor color, QColor color2, StarlightSpeed speed);
     bool setStarlightRandom(StarlightSpeed speed);
+    PendingReply<bool> setStarlightRandomAsync(StarlightSpeed speed);
     // bw2013
     bool setStatic_bw2013();
+    PendingReply<bool> setStatic_bw2013Async();
     bool setPulsate();
+    PendingReply<bool> setPulsateAsync();
 
     bool getBacklightActive();
+    PendingReply<bool> getBacklightActiveAsync();
     bool setBacklightActive(bool active);
+    PendingReply<bool> setBacklightActiveAsync(bool active);
     uchar getBacklightEffect();
+    PendingReply<uchar> getBacklightEffectAsync();
     bool setBacklightBrightness(double brightness);
+    PendingReply<bool> setBacklightBrightnessAsync(double brightness);
+    void setBacklightBrightnessQueued(double brightness);
     double getBacklightBrightness();
+    PendingReply<double> getBacklightBrightnessAsync();
     bool setBacklightStatic(QColor color);
+    PendingReply<bool> setBacklightStaticAsync(QColor color);
     bool setBacklightSpectrum();
+    PendingReply<bool> setBacklightSpectrumAsync();
 
     // - Custom(?) -
     bool setCustom();
+    PendingReply<bool> setCustomAsync();
     bool setKeyRow(uchar row, uchar startcol, uchar endcol, QVector<QColor> colors);
+    PendingReply<bool> setKeyRowAsync(uchar row, uchar startcol, uchar endcol, QVector<QColor> colors);
+    bool setMatrixFrame(const QVector<QVector<QColor>> &frame, bool custom = true);
+    PendingReply<bool> setMatrixFrameAsync(const QVector<QVector<QColor>> &frame, bool custom = true);
+    bool setMatrixFrame(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom = true);
+    PendingReply<bool> setMatrixFrameAsync(const uchar *pixels, int rows, int columns, FrameEncoder::PixelFormat format, bool custom = true);
+    void invalidateMatrixFrame();
+    void setMatrixFrameWindow(int frames);
 
     // - Custom -
     bool setRipple(QColor color, double refresh_rate);
+    PendingReply<bool> setRippleAsync(QColor color, double refresh_rate);
     bool setRippleRandomColor(double refresh_rate);
+    PendingReply<bool> setRippleRandomColorAsync(double refresh_rate);
 
     bool setBrightness(double brightness);
+    PendingReply<bool> setBrightnessAsync(double brightness);
+    void setBrightnessQueued(double brightness);
     double getBrightness();
+    PendingReply<double> getBrightnessAsync();
 
     // - Logo -
     bool setLogoStatic(QColor color);
+    PendingReply<bool> setLogoStaticAsync(QColor color);
     bool setLogoActive(bool active);
+    PendingReply<bool> setLogoActiveAsync(bool active);
     bool getLogoActive();
+    PendingReply<bool> getLogoActiveAsync();
     uchar getLogoEffect();
+    PendingReply<uchar> getLogoEffectAsync();
     bool setLogoBlinking(QColor color);
+    PendingReply<bool> setLogoBlinkingAsync(QColor color);
     bool setLogoPulsate(QColor color);
+    PendingReply<bool> setLogoPulsateAsync(QColor color);
     bool setLogoSpectrum();
+    PendingReply<bool> setLogoSpectrumAsync();
     bool setLogoNone();
+    PendingReply<bool> setLogoNoneAsync();
     bool setLogoReactive(QColor color, ReactiveSpeed speed);
+    PendingReply<bool> setLogoReactiveAsync(QColor color, ReactiveSpeed speed);
     bool setLogoBreathSingle(QColor color);
+    PendingReply<bool> setLogoBreathSingleAsync(QColor color);
     bool setLogoBreathDual(QColor color, QColor color2);
+    PendingReply<bool> setLogoBreathDualAsync(QColor color, QColor color2);
     bool setLogoBreathRandom();
+    PendingReply<bool> setLogoBreathRandomAsync();
 
     bool setLogoBrightness(double brightness);
+    PendingReply<bool> setLogoBrightnessAsync(double brightness);
+    void setLogoBrightnessQueued(double brightness);
     double getLogoBrightness();
+    PendingReply<double> getLogoBrightnessAsync();
 
     // - Scroll -
     bool setScrollStatic(QColor color);
+    PendingReply<bool> setScrollStaticAsync(QColor color);
     bool setScrollActive(bool active);
+    PendingReply<bool> setScrollActiveAsync(bool active);
     bool getScrollActive();
+    PendingReply<bool> getScrollActiveAsync();
     uchar getScrollEffect();
+    PendingReply<uchar> getScrollEffectAsync();
     bool setScrollBlinking(QColor color);
+    PendingReply<bool> setScrollBlinkingAsync(QColor color);
     bool setScrollPulsate(QColor color);
+    PendingReply<bool> setScrollPulsateAsync(QColor color);
     bool setScrollSpectrum();
+    PendingReply<bool> setScrollSpectrumAsync();
     bool setScrollNone();
+    PendingReply<bool> setScrollNoneAsync();
     bool setScrollReactive(QColor color, ReactiveSpeed speed);
+    PendingReply<bool> setScrollReactiveAsync(QColor color, ReactiveSpeed speed);
     bool setScrollBreathSingle(QColor color);
+    PendingReply<bool> setScrollBreathSingleAsync(QColor color);
     bool setScrollBreathDual(QColor color, QColor color2);
+    PendingReply<bool> setScrollBreathDualAsync(QColor color, QColor color2);
     bool setScrollBreathRandom();
+    PendingReply<bool> setScrollBreathRandomAsync();
 
     bool setScrollBrightness(double brightness);
+    PendingReply<bool> setScrollBrightnessAsync(double brightness);
+    void setScrollBrightnessQueued(double brightness);
     double getScrollBrightness();
+    PendingReply<double> getScrollBrightnessAsync();
 
     // - Profile LED -
     bool getBlueLED();
+    PendingReply<bool> getBlueLEDAsync();
     bool setBlueLED(bool on);
+    PendingReply<bool> setBlueLEDAsync(bool on);
     bool getGreenLED();
+    PendingReply<bool> getGreenLEDAsync();
     bool setGreenLED(bool on);
+    PendingReply<bool> setGreenLEDAsync(bool on);
     bool getRedLED();
+    PendingReply<bool> getRedLEDAsync();
     bool setRedLED(bool on);
+    PendingReply<bool> setRedLEDAsync(bool on);
 
     enum LightingLocation { Lighting, LightingLogo, LightingScroll, LightingBacklight };
 };
@@ -271,4 +464,8 @@ public:
 // Needed for casting from QVariant
 Q_DECLARE_METATYPE(libopenrazer::PollRate)
 
+// Need the complete Device
+#include "devicebatch.h"
+#include "effects.h"
+
 #endif // LIBRAZER_H
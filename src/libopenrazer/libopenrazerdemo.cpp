@@ -19,7 +19,7 @@ int main()
         qDebug() << "Driver version:" << device.getDriverVersion();
         qDebug() << "Serial: " << str;
 
-        if(device.hasCapability("dpi")) {
+        if(device.hasCapability(libopenrazer::CAP_DPI)) {
             qDebug() << "DPI";
             qDebug() << device.getDPI();
             device.setDPI(500, 500);
@@ -27,41 +27,41 @@ int main()
             qDebug() << "maxdpi: " << device.maxDPI();
         }
 
-        if(device.hasCapability("mug")) {
+        if(device.hasCapability(libopenrazer::CAP_MUG)) {
             qDebug() << "isMugPresent";
             qDebug() << device.isMugPresent();
         }
 
-        if(device.hasCapability("poll_rate")) {
+        if(device.hasCapability(libopenrazer::CAP_POLL_RATE)) {
             qDebug() << "Set_pollrate:" << device.setPollRate(libopenrazer::POLL_125HZ);
             qDebug() << "Pollrate:" << device.getPollRate();
             qDebug() << "Set_pollrate:" << device.setPollRate(libopenrazer::POLL_1000HZ);
             qDebug() << "Pollrate:" << device.getPollRate();
         }
 
-        if(device.hasCapability("get_brightness")) {
+        if(device.hasCapability(libopenrazer::CAP_GET_BRIGHTNESS)) {
             qDebug() << "getBrightness";
             qDebug() << device.getBrightness();
         }
-        if(device.hasCapability("get_lighting_logo_brightness")) {
+        if(device.hasCapability(libopenrazer::CAP_GET_LIGHTING_LOGO_BRIGHTNESS)) {
             qDebug() << "getLogoBrightness";
             qDebug() << device.getLogoBrightness();
         }
-        if(device.hasCapability("get_lighting_scroll_brightness")) {
+        if(device.hasCapability(libopenrazer::CAP_GET_LIGHTING_SCROLL_BRIGHTNESS)) {
             qDebug() << "getScrollBrightness";
             qDebug() << device.getScrollBrightness();
         }
-        if(device.hasCapability("backlight")) {
+        if(device.hasCapability(libopenrazer::CAP_BACKLIGHT)) {
             qDebug() << "Backlight:";
             qDebug() << device.getBacklightActive();
             qDebug() << device.setBacklightActive(false);
             qDebug() << device.getBacklightActive();
         }
-        if(device.hasCapability("kbd_layout")) {
+        if(device.hasCapability(libopenrazer::CAP_KBD_LAYOUT)) {
             qDebug() << "Keyboard layout:";
             qDebug() << device.getKeyboardLayout();
         }
-        if(device.hasCapability("battery")) {
+        if(device.hasCapability(libopenrazer::CAP_BATTERY)) {
             qDebug() << "Battery:";
             qDebug() << "level: " << device.getBatteryLevel();
             qDebug() << "isCharging: " << device.isCharging();
@@ -0,0 +1,127 @@
+#include "libopenrazer.h"
+#include "standinservice.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
+
+// Calls into one device from several threads at once. This only exercises the code, it proves nothing by itself:
+// races are reported when it runs in a build with ThreadSanitizer, see ENABLE_TSAN (CMake) and enable_tsan (meson),
+// and only for the races these particular runs happen to hit.
+// Without a serial it runs against a stand-in daemon with one device, that is how the test suite runs it.
+// Usage: libopenrazerstress [serial or - for the first device of the daemon] [iterations]
+
+#define STANDIN_SERIAL "STANDIN0001"
+
+// Answers the calls the tasks below make, for a 6x22 keyboard
+static void setUpStandInDaemon(StandInService *daemon)
+{
+    daemon->reply("razer.device.misc", "getDeviceName", QString("Stand-in Keyboard"));
+    daemon->reply("razer.device.misc", "getDeviceType", QString("keyboard"));
+    daemon->reply("razer.device.misc", "getVidPid", QVariant::fromValue(QList<int>() << 0x1532 << 0x0203));
+    daemon->reply("razer.device.misc", "getRazerUrls", QString("{}"));
+    daemon->reply("razer.device.misc", "hasMatrix", true);
+    daemon->reply("razer.device.misc", "getMatrixDimensions", QVariant::fromValue(QList<int>() << 6 << 22));
+    daemon->reply("razer.device.lighting.brightness", "getBrightness", 50.0);
+    daemon->reply("razer.device.lighting.brightness", "setBrightness");
+    daemon->reply("razer.device.lighting.chroma", "setKeyRow");
+    daemon->reply("razer.device.lighting.chroma", "setCustom");
+}
+
+class StressTask : public QRunnable
+{
+public:
+    StressTask(libopenrazer::Device *device, int index, int iterations) : device(device), index(index), iterations(iterations) {}
+
+    void run() override
+    {
+        QList<int> dimensions;
+        if(device->hasCapability(libopenrazer::CAP_LIGHTING_LED_MATRIX)) {
+            dimensions = device->getMatrixDimensions();
+        }
+        for(int i=0; i<iterations; i++) {
+            switch((index + i) % 4) {
+            case 0:
+                device->getDeviceName();
+                device->getVid();
+                device->getBrightnessAsync().value();
+                break;
+            case 1:
+                if(dimensions.size() == 2) {
+                    QVector<QVector<QColor>> frame(dimensions[0], QVector<QColor>(dimensions[1], QColor::fromHsv((i * 7) % 360, 255, 255)));
+                    device->setMatrixFrame(frame);
+                } else {
+                    device->invalidateMatrixFrame();
+                }
+                break;
+            case 2:
+                device->properties()->value(libopenrazer::DeviceProperties::Brightness);
+                device->properties()->refresh(libopenrazer::DeviceProperties::Brightness);
+                device->setBrightness(i % 100);
+                break;
+            case 3:
+                device->setBrightnessQueued(i % 100);
+                device->commandQueue()->pendingCount();
+                break;
+            }
+        }
+    }
+private:
+    libopenrazer::Device *device;
+    int index;
+    int iterations;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString serial = argc > 1 ? argv[1] : "";
+    int iterations = argc > 2 ? atoi(argv[2]) : 200;
+
+    StandInService daemon("org.razer", "/org/razer");
+    if(serial.isEmpty()) {
+        if(!hasSessionBus()) {
+            return TEST_SKIPPED;
+        }
+        setUpStandInDaemon(&daemon);
+        if(!daemon.start()) {
+            return 1;
+        }
+        serial = STANDIN_SERIAL;
+    } else if(serial == "-") {
+        // The first device of the real daemon
+        QStringList serials = libopenrazer::getConnectedDevices();
+        if(serials.isEmpty()) {
+            qWarning() << "No device connected.";
+            return 1;
+        }
+        serial = serials.first();
+    }
+
+    libopenrazer::startIoThread();
+    libopenrazer::Device device(serial);
+    QString name = device.getDeviceName();
+    if(name.isEmpty()) {
+        qWarning() << "Device" << serial << "not found.";
+        return 1;
+    }
+    qDebug() << "Stressing" << name << "(" << serial << ")";
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(8);
+    for(int i=0; i<pool.maxThreadCount(); i++) {
+        pool.start(new StressTask(&device, i, iterations));
+    }
+    // Replies and the queued calls are handled in this thread
+    while(!pool.waitForDone(10)) {
+        app.processEvents();
+    }
+    app.processEvents();
+    libopenrazer::stopIoThread();
+    app.processEvents();
+    daemon.stop();
+
+    qDebug() << "Done.";
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PENDINGREPLY_H
+#define PENDINGREPLY_H
+
+#include <functional>
+#include <memory>
+
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "callpolicy.h"
+
+namespace libopenrazer
+{
+// A call sent once the call of a PendingReply succeeded, see PendingReply::followedBy()
+struct FollowUpCall {
+    QMutex mutex;
+    std::function<QDBusPendingCall()> send;
+    // Empty until sent
+    QList<QDBusPendingCall> call;
+
+    // Sends the call unless it was sent already, and returns it
+    QDBusPendingCall start()
+    {
+        QMutexLocker locker(&mutex);
+        if(call.isEmpty()) {
+            call.append(send());
+        }
+        return call.first();
+    }
+    QList<QDBusPendingCall> sent()
+    {
+        QMutexLocker locker(&mutex);
+        return call;
+    }
+};
+
+template<typename T>
+class PendingReply
+{
+public:
+    typedef T (*Converter)(const QDBusMessage &reply);
+
+    PendingReply(const QDBusPendingCall &call, Converter converter, const QDBusMessage &message = QDBusMessage()) : call(call), converter(converter), message(message), finished(false) {}
+
+    // Makes the reply fail with the error of call, sent with message before this one, if it fails
+    PendingReply<T> &after(const QDBusPendingCall &call, const QDBusMessage &message)
+    {
+        before.append(call);
+        beforeMessages.append(message);
+        return *this;
+    }
+
+    // Sends the call made by send once this one succeeded, from the event loop of the current thread or when waiting for the reply. The reply finishes with that call then.
+    PendingReply<T> &followedBy(const std::function<QDBusPendingCall()> &send)
+    {
+        std::shared_ptr<FollowUpCall> f = std::make_shared<FollowUpCall>();
+        f->send = send;
+        followUp = f;
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, [f](QDBusPendingCallWatcher *w) {
+            w->deleteLater();
+            if(!w->isError()) {
+                f->start();
+            }
+        });
+        return *this;
+    }
+
+    QDBusPendingCall pendingCall() const
+    {
+        return call;
+    }
+    bool isFinished() const
+    {
+        for(int i=0; i<before.size(); i++) {
+            if(!before[i].isFinished())
+                return false;
+        }
+        if(followUp && call.isFinished() && !call.isError()) {
+            QList<QDBusPendingCall> sent = followUp->sent();
+            return !sent.isEmpty() && sent.first().isFinished();
+        }
+        return call.isFinished();
+    }
+    bool isError() const
+    {
+        return failedCall().isError();
+    }
+    QDBusError error() const
+    {
+        return failedCall().error();
+    }
+    CallError callError() const
+    {
+        return toCallError(error());
+    }
+    void waitForFinished() const
+    {
+        if(!finished) {
+            for(int i=0; i<before.size(); i++) {
+                finishPendingCall(beforeMessages[i], &before[i]);
+            }
+            finishPendingCall(message, &call);
+            if(followUp && !call.isError()) {
+                followUp->start().waitForFinished();
+            }
+            finished = true;
+        }
+    }
+    T value() const
+    {
+        waitForFinished();
+        return converter(failedCall().reply());
+    }
+    T convert(const QDBusMessage &reply) const
+    {
+        return converter(reply);
+    }
+    // Calls callback with the value once the reply arrived, in the thread of context which has to be the current one.
+    // A call not reaching the daemon is retried from the event loop according to the call policy.
+    template<typename F>
+    void then(QObject *context, F callback) const
+    {
+        PendingReply<T> self(*this);
+        watchPendingCall(message, call, context, [self, context, callback](const QDBusPendingCall &finished) {
+            self.call = finished;
+            // The daemon answers the calls in order, so the ones before have their reply already
+            QDBusPendingCall failed = self.failedCall();
+            if(failed.isError()) {
+                callback(self.convert(failed.reply()));
+            } else if(self.followUp) {
+                QDBusPendingCallWatcher *next = new QDBusPendingCallWatcher(self.followUp->start(), context);
+                QObject::connect(next, &QDBusPendingCallWatcher::finished, context, [self, callback](QDBusPendingCallWatcher *n) {
+                    n->deleteLater();
+                    callback(self.convert(n->reply()));
+                });
+            } else {
+                callback(self.convert(finished.reply()));
+            }
+        });
+    }
+private:
+    // Returns the first call before this one that failed, or the follow-up call once sent, or this one
+    QDBusPendingCall failedCall() const
+    {
+        for(int i=0; i<before.size(); i++) {
+            if(before[i].isError())
+                return before[i];
+        }
+        if(followUp && !call.isError()) {
+            QList<QDBusPendingCall> sent = followUp->sent();
+            if(!sent.isEmpty())
+                return sent.first();
+        }
+        return call;
+    }
+
+    // Replaced by the retried call
+    mutable QDBusPendingCall call;
+    mutable QList<QDBusPendingCall> before;
+    QList<QDBusMessage> beforeMessages;
+    Converter converter;
+    QDBusMessage message;
+    mutable bool finished;
+    std::shared_ptr<FollowUpCall> followUp;
+};
+}
+
+#endif // PENDINGREPLY_H
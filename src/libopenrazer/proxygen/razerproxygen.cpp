@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Generates razerproxies.h from introspection XML of the daemon.
+ *
+ * For every method of every interface an inline function in libopenrazer::proxy::<interface> is generated,
+ * building the QDBusMessage for a device object path with the arguments in the D-Bus types the daemon expects.
+ *
+ * Usage: razerproxygen <output.h> <introspection.xml>...
+ * Interfaces found in more than one file are merged.
+ */
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMap>
+#include <QStringList>
+#include <QTextStream>
+#include <QXmlStreamReader>
+
+#include <cstdio>
+
+struct Arg {
+    QString name;
+    QString type;
+};
+
+struct Method {
+    QList<Arg> in;
+    QString out;
+};
+
+typedef QMap<QString, QMap<QString, Method>> Interfaces;
+
+/**
+ * Returns the C++ parameter type for the D-Bus signature \a type.
+ */
+static QString cppType(const QString &type)
+{
+    static const QMap<QString, QString> types = {
+        {"y", "uchar"}, {"b", "bool"}, {"n", "short"}, {"q", "ushort"}, {"i", "int"}, {"u", "uint"},
+        {"x", "qlonglong"}, {"t", "qulonglong"}, {"d", "double"}, {"s", "const QString &"},
+        {"ay", "const QByteArray &"}, {"as", "const QStringList &"}, {"ai", "const QList<int> &"}
+    };
+    return types.value(type, "const QVariant &");
+}
+
+/**
+ * Reads the interfaces of \a filename into \a interfaces. Returns false if the file can't be parsed.
+ */
+static bool parse(const QString &filename, Interfaces *interfaces)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "razerproxygen: Can't open %s\n", qPrintable(filename));
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString interface;
+    QString method;
+    Method current;
+    while(!xml.atEnd()) {
+        xml.readNext();
+        if(xml.isStartElement()) {
+            QXmlStreamAttributes attributes = xml.attributes();
+            if(xml.name() == "interface") {
+                interface = attributes.value("name").toString();
+            } else if(xml.name() == "method") {
+                method = attributes.value("name").toString();
+                current = Method();
+            } else if(xml.name() == "arg" && !method.isEmpty()) {
+                Arg arg;
+                arg.type = attributes.value("type").toString();
+                arg.name = attributes.value("name").toString();
+                if(attributes.value("direction") == "out") {
+                    current.out = arg.type;
+                } else {
+                    if(arg.name.isEmpty()) {
+                        arg.name = QString("arg%1").arg(current.in.size());
+                    }
+                    current.in.append(arg);
+                }
+            }
+        } else if(xml.isEndElement()) {
+            if(xml.name() == "method") {
+                // The standard interfaces are handled by QtDBus
+                if(!interface.startsWith("org.freedesktop.DBus") && !(*interfaces)[interface].contains(method)) {
+                    (*interfaces)[interface].insert(method, current);
+                }
+                method.clear();
+            } else if(xml.name() == "interface") {
+                interface.clear();
+            }
+        }
+    }
+    if(xml.hasError()) {
+        fprintf(stderr, "razerproxygen: %s:%lld: %s\n", qPrintable(filename), (long long)xml.lineNumber(), qPrintable(xml.errorString()));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Writes the inline function building the message for \a name of \a interface.
+ */
+static void writeMethod(QTextStream &out, const QString &interface, const QString &name, const Method &method)
+{
+    QStringList params("const QString &path");
+    foreach(const Arg &arg, method.in) {
+        params.append(cppType(arg.type) + (cppType(arg.type).endsWith('&') ? "" : " ") + arg.name);
+    }
+    if(!method.out.isEmpty()) {
+        out << "// Replies with " << method.out << "\n";
+    }
+    out << "inline QDBusMessage " << name << "(" << params.join(", ") << ")\n";
+    out << "{\n";
+    out << "    QDBusMessage m = QDBusMessage::createMethodCall(QStringLiteral(\"org.razer\"), path, QStringLiteral(\"" << interface << "\"), QStringLiteral(\"" << name << "\"));\n";
+    if(!method.in.isEmpty()) {
+        out << "    QList<QVariant> args;\n";
+        out << "    args.reserve(" << method.in.size() << ");\n";
+        foreach(const Arg &arg, method.in) {
+            out << "    args.append(QVariant::fromValue(" << arg.name << "));\n";
+        }
+        out << "    m.setArguments(args);\n";
+    }
+    out << "    return m;\n";
+    out << "}\n";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    if(arguments.size() < 3) {
+        fprintf(stderr, "Usage: razerproxygen <output.h> <introspection.xml>...\n");
+        return 1;
+    }
+
+    Interfaces interfaces;
+    for(int i=2; i<arguments.size(); i++) {
+        if(!parse(arguments[i], &interfaces)) {
+            return 1;
+        }
+    }
+
+    QFile file(arguments[1]);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        fprintf(stderr, "razerproxygen: Can't write %s\n", qPrintable(arguments[1]));
+        return 1;
+    }
+    QTextStream out(&file);
+    out << "// Generated by razerproxygen from the introspection XML of the daemon, do not edit.\n\n";
+    out << "#ifndef RAZERPROXIES_H\n#define RAZERPROXIES_H\n\n";
+    out << "#include <QByteArray>\n#include <QDBusMessage>\n#include <QList>\n#include <QString>\n#include <QStringList>\n#include <QVariant>\n\n";
+    out << "namespace libopenrazer\n{\nnamespace proxy\n{\n";
+
+    for(Interfaces::const_iterator it = interfaces.constBegin(); it != interfaces.constEnd(); ++it) {
+        // razer.device.dpi -> namespace razer { namespace device { namespace dpi {
+        QStringList parts = it.key().split('.');
+        out << "\n// " << it.key() << "\n";
+        foreach(const QString &part, parts) {
+            out << "namespace " << part << "\n{\n";
+        }
+        for(QMap<QString, Method>::const_iterator m = it.value().constBegin(); m != it.value().constEnd(); ++m) {
+            writeMethod(out, it.key(), m.key(), m.value());
+        }
+        for(int i=0; i<parts.size(); i++) {
+            out << "}\n";
+        }
+    }
+
+    out << "\n}\n}\n\n#endif // RAZERPROXIES_H\n";
+    return 0;
+}
@@ -0,0 +1,163 @@
+#ifndef STANDINSERVICE_H
+#define STANDINSERVICE_H
+
+#include <cstdio>
+#include <functional>
+
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusVirtualObject>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+
+// Exit code of a test that couldn't run, e.g. without a session bus. CTest and meson report it as skipped.
+#define TEST_SKIPPED 77
+
+// Stands in for a D-Bus service like the daemon or systemd in the test executables.
+// It has its own connection to the session bus and answers from its own thread, so the library can block on its calls.
+// The tests run on a bus of their own, see dbus-run-session, so the name is free.
+class StandInService : public QDBusVirtualObject
+{
+public:
+    // Returns the reply to a call. An invalid message leaves the call unanswered, so it times out.
+    typedef std::function<QDBusMessage(const QDBusMessage &call)> Handler;
+
+    StandInService(const QString &service, const QString &path) : service(service), path(path), connectionName("standin-" + service)
+    {
+    }
+
+    ~StandInService()
+    {
+        stop();
+    }
+
+    // Answers calls of \a member in \a interface on all paths below the path of the service
+    void handle(const QString &interface, const QString &member, const Handler &handler)
+    {
+        QMutexLocker locker(&mutex);
+        handlers.insert(interface + "." + member, handler);
+    }
+
+    // Answers calls of \a member in \a interface with \a value, or an empty reply if it isn't valid
+    void reply(const QString &interface, const QString &member, const QVariant &value = QVariant())
+    {
+        handle(interface, member, [value](const QDBusMessage &call) {
+            return value.isValid() ? call.createReply(value) : call.createReply();
+        });
+    }
+
+    bool start()
+    {
+        QDBusConnection connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, connectionName);
+        if(!connection.isConnected()) {
+            return false;
+        }
+        thread.start();
+        moveToThread(&thread);
+        if(!connection.registerVirtualObject(path, this, QDBusConnection::SubPath) || !connection.registerService(service)) {
+            fprintf(stderr, "Failed to register %s: %s\n", qPrintable(service), qPrintable(connection.lastError().message()));
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    void stop()
+    {
+        if(!thread.isRunning()) {
+            return;
+        }
+        QDBusConnection connection(connectionName);
+        connection.unregisterService(service);
+        connection.unregisterObject(path, QDBusConnection::UnregisterTree);
+        QDBusConnection::disconnectFromBus(connectionName);
+        thread.quit();
+        thread.wait();
+    }
+
+    // Releases or takes back the name of the service while running, calls to it then fail as if the service wasn't there
+    bool setRegistered(bool registered)
+    {
+        QDBusConnection connection(connectionName);
+        return registered ? connection.registerService(service) : connection.unregisterService(service);
+    }
+
+    // Returns the calls answered so far as "interface.member", in the order they arrived
+    QStringList calls() const
+    {
+        QMutexLocker locker(&mutex);
+        return log;
+    }
+
+    void clearCalls()
+    {
+        QMutexLocker locker(&mutex);
+        log.clear();
+    }
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override
+    {
+        if(message.interface() == "org.freedesktop.DBus.Introspectable") {
+            // Answered by Qt from introspect()
+            return false;
+        }
+        QString key = message.interface() + "." + message.member();
+        Handler handler;
+        {
+            QMutexLocker locker(&mutex);
+            log.append(key);
+            handler = handlers.value(key);
+        }
+        QDBusMessage reply = handler ? handler(message) : message.createErrorReply(QDBusError::UnknownMethod, "No stand-in for " + key);
+        if(reply.type() != QDBusMessage::InvalidMessage) {
+            connection.send(reply);
+        }
+        return true;
+    }
+
+    QString introspect(const QString &) const override
+    {
+        QMap<QString, QStringList> interfaces;
+        {
+            QMutexLocker locker(&mutex);
+            foreach(const QString &key, handlers.keys()) {
+                int dot = key.lastIndexOf('.');
+                interfaces[key.left(dot)].append(key.mid(dot + 1));
+            }
+        }
+        QString xml;
+        for(QMap<QString, QStringList>::const_iterator it = interfaces.constBegin(); it != interfaces.constEnd(); ++it) {
+            xml += "<interface name=\"" + it.key() + "\">";
+            foreach(const QString &member, it.value()) {
+                xml += "<method name=\"" + member + "\"/>";
+            }
+            xml += "</interface>";
+        }
+        return xml;
+    }
+private:
+    QString service;
+    QString path;
+    QString connectionName;
+    QThread thread;
+    mutable QMutex mutex;
+    QHash<QString, Handler> handlers;
+    QStringList log;
+};
+
+// Returns if the test can reach a session bus, reporting why not otherwise
+inline bool hasSessionBus()
+{
+    if(!QDBusConnection::sessionBus().isConnected()) {
+        fprintf(stderr, "No session bus, run the test with dbus-run-session.\n");
+        return false;
+    }
+    return true;
+}
+
+#endif // STANDINSERVICE_H
@@ -0,0 +1,129 @@
+#include "libopenrazer.h"
+#include "standinservice.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+
+// Checks getDaemonStatusAsync() and enableDaemonAsync() against a stand-in for the systemd user instance:
+// the unit file states, a missing unit, and that Reload is only sent once EnableUnitFiles succeeded.
+
+#define MANAGER "org.freedesktop.systemd1.Manager"
+#define UNIT "openrazer-daemon.service"
+
+static int failures = 0;
+
+static void check(bool condition, const char *what)
+{
+    if(!condition) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Handles events for ms milliseconds, so calls sent from the event loop go out
+static void processEvents(int ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(timer.elapsed() < ms) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+}
+
+// Answers GetUnitFileState for the daemon's unit with state, or with the error errorName if it isn't empty
+static void setUnitFileState(StandInService *systemd, const QString &state, const QString &errorName = QString())
+{
+    systemd->handle(MANAGER, "GetUnitFileState", [state, errorName](const QDBusMessage &call) {
+        if(call.arguments().value(0).toString() != UNIT) {
+            return call.createErrorReply(QDBusError::InvalidArgs, "Unexpected unit");
+        }
+        return errorName.isEmpty() ? call.createReply(state) : call.createErrorReply(errorName, "Unit " UNIT " not found.");
+    });
+}
+
+// Answers EnableUnitFiles for the daemon's unit, or fails it with errorName if it isn't empty
+static void setEnableResult(StandInService *systemd, const QString &errorName = QString())
+{
+    systemd->handle(MANAGER, "EnableUnitFiles", [errorName](const QDBusMessage &call) {
+        QList<QVariant> args = call.arguments();
+        if(args.size() != 3 || args[0].toStringList() != QStringList(UNIT) || args[1].toBool() || args[2].toBool()) {
+            return call.createErrorReply(QDBusError::InvalidArgs, "Unexpected arguments");
+        }
+        if(!errorName.isEmpty()) {
+            return call.createErrorReply(errorName, "Access denied");
+        }
+        // The real reply also lists the changes, which nobody reads
+        return call.createReply(false);
+    });
+}
+
+static void testDaemonStatus(StandInService *systemd)
+{
+    setUnitFileState(systemd, "enabled");
+    check(libopenrazer::getDaemonStatusAsync().value() == libopenrazer::DaemonStatus::Enabled, "status: enabled unit");
+    setUnitFileState(systemd, "disabled");
+    check(libopenrazer::getDaemonStatus() == libopenrazer::DaemonStatus::Disabled, "status: disabled unit");
+    setUnitFileState(systemd, "masked");
+    check(libopenrazer::getDaemonStatus() == libopenrazer::DaemonStatus::Unknown, "status: other unit file states are unknown");
+    setUnitFileState(systemd, QString(), "org.freedesktop.systemd1.NoSuchUnit");
+    check(libopenrazer::getDaemonStatus() == libopenrazer::DaemonStatus::NotInstalled, "status: missing unit");
+
+    // The bus might try to activate systemd and fail differently then, so only check that no state is made up
+    systemd->setRegistered(false);
+    libopenrazer::DaemonStatus status = libopenrazer::getDaemonStatus();
+    check(status != libopenrazer::DaemonStatus::Enabled && status != libopenrazer::DaemonStatus::Disabled, "status: without systemd on the bus");
+    systemd->setRegistered(true);
+}
+
+static void testEnableDaemon(StandInService *systemd)
+{
+    systemd->reply(MANAGER, "Reload");
+
+    setEnableResult(systemd);
+    systemd->clearCalls();
+    check(libopenrazer::enableDaemon(), "enable: succeeds");
+    check(systemd->calls() == QStringList() << MANAGER ".EnableUnitFiles" << MANAGER ".Reload", "enable: reloads after enabling");
+
+    // Reload is sent from the event loop with then()
+    systemd->clearCalls();
+    QObject context;
+    bool called = false;
+    bool enabled = false;
+    libopenrazer::enableDaemonAsync().then(&context, [&called, &enabled](bool ok) {
+        called = true;
+        enabled = ok;
+    });
+    processEvents(1000);
+    check(called && enabled, "enable: then() gets the reply to the reload");
+    check(systemd->calls() == QStringList() << MANAGER ".EnableUnitFiles" << MANAGER ".Reload", "enable: then() reloads after enabling");
+
+    setEnableResult(systemd, "org.freedesktop.DBus.Error.AccessDenied");
+    systemd->clearCalls();
+    check(!libopenrazer::enableDaemonAsync().value(), "enable: fails with EnableUnitFiles");
+    processEvents(200);
+    check(systemd->calls() == QStringList() << MANAGER ".EnableUnitFiles", "enable: no reload after a failure");
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if(!hasSessionBus()) {
+        return TEST_SKIPPED;
+    }
+
+    StandInService systemd("org.freedesktop.systemd1", "/org/freedesktop/systemd1");
+    if(!systemd.start()) {
+        return 1;
+    }
+
+    testDaemonStatus(&systemd);
+    testEnableDaemon(&systemd);
+
+    systemd.stop();
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed.\n", failures);
+        return 1;
+    }
+    qDebug() << "All checks passed.";
+    return 0;
+}
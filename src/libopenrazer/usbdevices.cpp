@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include "usbdevices.h"
+
+namespace libopenrazer
+{
+
+/**
+ * Reads a hexadecimal sysfs attribute like idVendor. Returns -1 if the file doesn't exist or can't be parsed.
+ */
+static int readHexAttribute(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    // The attributes are 4 hex digits and a newline
+    bool ok;
+    int value = file.read(16).trimmed().toInt(&ok, 16);
+    return ok ? value : -1;
+}
+
+/*!
+ * \fn QList<UsbId> libopenrazer::getConnectedUsbDevices(int vid, const QString &sysfsPath)
+ *
+ * Returns the VID and PID of every USB device with the vendor ID \a vid that Linux detected, no matter if the daemon supports it.
+ * The devices are read from the \c idVendor and \c idProduct attributes in \a sysfsPath, which defaults to \c /sys/bus/usb/devices.
+ *
+ * \sa SupportedDeviceIndex
+ */
+QList<UsbId> getConnectedUsbDevices(int vid, const QString &sysfsPath)
+{
+    QList<UsbId> devices;
+    // Interfaces (e.g. "1-1:1.0") are listed next to the devices but don't have the attributes
+    QStringList entries = QDir(sysfsPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    foreach(const QString &entry, entries) {
+        QString path = sysfsPath + "/" + entry + "/";
+        if(readHexAttribute(path + "idVendor") != vid) {
+            continue;
+        }
+        int pid = readHexAttribute(path + "idProduct");
+        if(pid == -1) {
+            qWarning() << "libopenrazer: Error while reading the product ID of" << path;
+            continue;
+        }
+        devices.append(qMakePair(vid, pid));
+    }
+    return devices;
+}
+
+/*!
+ * \class libopenrazer::SupportedDeviceIndex
+ * \inmodule libopenrazer
+ *
+ * \brief The libopenrazer::SupportedDeviceIndex class looks up devices in the list returned by getSupportedDevices() by their VID and PID.
+ *
+ * The list is hashed once on construction, afterwards a lookup doesn't depend on the number of supported devices.
+ */
+
+/*!
+ * \fn libopenrazer::SupportedDeviceIndex::SupportedDeviceIndex()
+ *
+ * Constructs an empty index.
+ */
+SupportedDeviceIndex::SupportedDeviceIndex()
+{
+}
+
+/*!
+ * \fn libopenrazer::SupportedDeviceIndex::SupportedDeviceIndex(const QVariantHash &supportedDevices)
+ *
+ * Constructs an index of \a supportedDevices, in the format returned by getSupportedDevices().
+ */
+SupportedDeviceIndex::SupportedDeviceIndex(const QVariantHash &supportedDevices)
+{
+    devices.reserve(supportedDevices.size());
+    QHashIterator<QString, QVariant> i(supportedDevices);
+    while(i.hasNext()) {
+        i.next();
+        QList<QVariant> list = i.value().toList();
+        if(list.count() != 2) {
+            qWarning() << "libopenrazer: Error while indexing the supported device" << i.key() << list;
+            continue;
+        }
+        devices.insert(key(list[0].toInt(), list[1].toInt()), i.key());
+    }
+}
+
+SupportedDeviceIndex::~SupportedDeviceIndex()
+{
+}
+
+/**
+ * Packs \a vid and \a pid, which are 16 bit each, into one hash key.
+ */
+quint32 SupportedDeviceIndex::key(int vid, int pid)
+{
+    return (quint32(vid & 0xFFFF) << 16) | quint32(pid & 0xFFFF);
+}
+
+/*!
+ * \fn bool libopenrazer::SupportedDeviceIndex::contains(int vid, int pid) const
+ *
+ * Returns if the device with the given \a vid and \a pid is supported.
+ */
+bool SupportedDeviceIndex::contains(int vid, int pid) const
+{
+    return devices.contains(key(vid, pid));
+}
+
+/*!
+ * \fn QString libopenrazer::SupportedDeviceIndex::name(int vid, int pid) const
+ *
+ * Returns the name of the device with the given \a vid and \a pid, or an empty string if it isn't supported.
+ */
+QString SupportedDeviceIndex::name(int vid, int pid) const
+{
+    return devices.value(key(vid, pid));
+}
+
+/*!
+ * \fn int libopenrazer::SupportedDeviceIndex::size() const
+ *
+ * Returns the number of indexed devices.
+ */
+int SupportedDeviceIndex::size() const
+{
+    return devices.size();
+}
+
+/*!
+ * \fn bool libopenrazer::SupportedDeviceIndex::isEmpty() const
+ *
+ * Returns if no device is indexed.
+ */
+bool SupportedDeviceIndex::isEmpty() const
+{
+    return devices.isEmpty();
+}
+
+}
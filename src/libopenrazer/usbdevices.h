@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef USBDEVICES_H
+#define USBDEVICES_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVariantHash>
+
+namespace libopenrazer
+{
+// USB vendor ID of Razer
+#define RAZER_USB_VID 0x1532
+
+// VID and PID of a USB device
+typedef QPair<int, int> UsbId;
+
+QList<UsbId> getConnectedUsbDevices(int vid = RAZER_USB_VID, const QString &sysfsPath = "/sys/bus/usb/devices");
+
+class SupportedDeviceIndex
+{
+public:
+    SupportedDeviceIndex();
+    explicit SupportedDeviceIndex(const QVariantHash &supportedDevices);
+    ~SupportedDeviceIndex();
+
+    bool contains(int vid, int pid) const;
+    QString name(int vid, int pid) const;
+    int size() const;
+    bool isEmpty() const;
+private:
+    static quint32 key(int vid, int pid);
+
+    QHash<quint32, QString> devices;
+};
+}
+
+#endif // USBDEVICES_H
@@ -0,0 +1,80 @@
+#include "usbdevices.h"
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstdio>
+
+// Reads the USB devices from a fake sysfs tree in a temporary directory and looks them up in a SupportedDeviceIndex.
+
+static int failures = 0;
+
+static void check(bool condition, const char *what)
+{
+    if(!condition) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Creates the directory entry in root with the given attributes, an empty value leaves the attribute out
+static void addEntry(const QString &root, const QString &entry, const QByteArray &idVendor, const QByteArray &idProduct)
+{
+    QDir(root).mkpath(entry);
+    if(!idVendor.isEmpty()) {
+        QFile file(root + "/" + entry + "/idVendor");
+        file.open(QIODevice::WriteOnly);
+        file.write(idVendor + "\n");
+    }
+    if(!idProduct.isEmpty()) {
+        QFile file(root + "/" + entry + "/idProduct");
+        file.open(QIODevice::WriteOnly);
+        file.write(idProduct + "\n");
+    }
+}
+
+int main()
+{
+    QTemporaryDir dir;
+    if(!dir.isValid()) {
+        fprintf(stderr, "Couldn't create a temporary directory.\n");
+        return 1;
+    }
+    QString devices = dir.path() + "/bus/usb/devices";
+    QDir().mkpath(devices);
+
+    addEntry(devices, "1-1", "1532", "0203");
+    addEntry(devices, "1-2", "046d", "c52b");
+    addEntry(devices, "usb1", "1d6b", "0002");
+    // Interfaces don't have the attributes
+    addEntry(devices, "1-1:1.0", "", "");
+    // Unreadable product ID
+    addEntry(devices, "1-3", "1532", "");
+    // Like in the real sysfs, the entries are links to the device directories
+    addEntry(dir.path(), "devices/pci0000:00/1-4", "1532", "0084");
+    QFile::link(dir.path() + "/devices/pci0000:00/1-4", devices + "/1-4");
+    // Files next to the devices are ignored
+    QFile uevent(devices + "/uevent");
+    uevent.open(QIODevice::WriteOnly);
+
+    QList<libopenrazer::UsbId> found = libopenrazer::getConnectedUsbDevices(RAZER_USB_VID, devices);
+    check(found.size() == 2, "finds the two Razer devices with a product ID");
+    check(found.contains(qMakePair(0x1532, 0x0203)), "finds a device directory");
+    check(found.contains(qMakePair(0x1532, 0x0084)), "follows a link to a device directory");
+    check(libopenrazer::getConnectedUsbDevices(0x046d, devices) == QList<libopenrazer::UsbId>() << qMakePair(0x046d, 0xc52b), "filters by the vendor ID");
+    check(libopenrazer::getConnectedUsbDevices(RAZER_USB_VID, dir.path() + "/missing").isEmpty(), "a missing sysfs path has no devices");
+
+    QVariantHash supported;
+    supported.insert("Razer BlackWidow Chroma", QVariantList() << 0x1532 << 0x0203);
+    supported.insert("Broken entry", QVariantList() << 0x1532);
+    libopenrazer::SupportedDeviceIndex index(supported);
+    check(index.size() == 1, "skips malformed supported devices");
+    check(index.contains(0x1532, 0x0203) && index.name(0x1532, 0x0203) == "Razer BlackWidow Chroma", "looks up a supported device");
+    check(!index.contains(0x1532, 0x0084) && index.name(0x1532, 0x0084).isEmpty(), "doesn't know an unsupported device");
+
+    if(failures > 0) {
+        fprintf(stderr, "%d checks failed.\n", failures);
+        return 1;
+    }
+    printf("All checks passed.\n");
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include <QCheckBox>
 #include <libopenrazer.h>
 #include <config.h>
+#include "razerimagedownloader.h"
 
 Preferences::Preferences(QWidget *parent) : QDialog(parent)
 {
@@ -51,9 +52,9 @@ Preferences::Preferences(QWidget *parent) : QDialog(parent)
 
     QCheckBox *downloadCheckBox = new QCheckBox(this);
     downloadCheckBox->setText(tr("Download device images"));
-    downloadCheckBox->setChecked(settings.value("downloadImages").toBool());
+    downloadCheckBox->setChecked(RazerImageDownloader::instance()->isDownloadEnabled());
     connect(downloadCheckBox, &QCheckBox::clicked, this, [=]( bool checked ) {
-        settings.setValue("downloadImages", checked);
+        RazerImageDownloader::instance()->setDownloadEnabled(checked);
     });
 
     QSpacerItem *spacer = new QSpacerItem(20, 40, QSizePolicy::Minimum, QSizePolicy::Expanding);
@@ -20,7 +20,6 @@
 #define PREFERENCES_H
 
 #include <QDialog>
-#include <QSettings>
 
 class Preferences : public QDialog
 {
@@ -29,7 +28,6 @@ public:
     Preferences(QWidget* parent = 0);
     ~Preferences();
 private:
-    QSettings settings;
 };
 
 #endif // PREFERENCES_H
@@ -24,11 +24,21 @@ RazerDeviceWidget::RazerDeviceWidget (const QString &name, const QString &serial
     this->serial = serial;
 }
 
+QString RazerDeviceWidget::getName()
+{
+    return name;
+}
+
 QString RazerDeviceWidget::getSerial()
 {
     return serial;
 }
 
+DeviceControls &RazerDeviceWidget::controls()
+{
+    return mControls;
+}
+
 RazerDeviceWidget::~RazerDeviceWidget()
 {
 }
@@ -19,18 +19,47 @@
 #ifndef RAZERDEVICEWIDGET_H
 #define RAZERDEVICEWIDGET_H
 
+#include <QCheckBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QRadioButton>
+#include <QSlider>
+#include <QTextEdit>
 #include <QWidget>
 
+// Widgets of one lighting location, NULL if the device doesn't have them
+struct ZoneControls {
+    QComboBox *comboBox = NULL;
+    QPushButton *colorButtons[3] = {NULL, NULL, NULL};
+    QRadioButton *waveLeft = NULL;
+    QRadioButton *waveRight = NULL;
+};
+
+// Widgets of a device page the slots need, set when the page is built
+struct DeviceControls {
+    // Indexed by libopenrazer::Device::LightingLocation
+    static const int ZoneCount = 4;
+    ZoneControls zones[ZoneCount];
+    QCheckBox *profileLeds[3] = {NULL, NULL, NULL};
+    QSlider *dpiX = NULL;
+    QSlider *dpiY = NULL;
+    QTextEdit *dpiXText = NULL;
+    QTextEdit *dpiYText = NULL;
+};
+
 class RazerDeviceWidget : public QWidget
 {
 public:
     RazerDeviceWidget(const QString& name, const QString& serial);
     ~RazerDeviceWidget();
 
+    QString getName();
     QString getSerial();
+    DeviceControls &controls();
 private:
     QString name;
     QString serial;
+    DeviceControls mControls;
 };
 
 #endif // RAZERDEVICEWIDGET_H
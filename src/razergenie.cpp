@@ -25,12 +25,12 @@
 
 #include "razergenie.h"
 #include "libopenrazer/libopenrazer.h"
-#include "libopenrazer/razercapability.h"
 #include "customeditor/customeditor.h"
 #include "preferences/preferences.h"
 #include "razerimagedownloader.h"
 #include "razerdevicewidget.h"
-#include "devicelistwidget.h"
+#include "devicelistmodel.h"
+#include "devicelistdelegate.h"
 #include "util.h"
 
 #define newIssueUrl "https://github.com/openrazer/openrazer/issues/new"
@@ -38,6 +38,14 @@
 #define troubleshootingUrl "https://github.com/openrazer/openrazer/wiki/Troubleshooting"
 #define websiteUrl "https://openrazer.github.io/"
 
+/**
+ * Returns the file the device cache is stored in. Should be ~/.local/share/razergenie/devicecache.json, next to the device pictures.
+ */
+static QString deviceCacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/razergenie/devicecache.json";
+}
+
 RazerGenie::RazerGenie(QWidget *parent) : QWidget(parent)
 {
     // Set the directory of the application to where the application is located. Needed for the custom editor and relative paths.
@@ -48,11 +56,13 @@ RazerGenie::RazerGenie(QWidget *parent) : QWidget(parent)
     // If enabled: Do nothing => DONE
     // If not_installed: "The daemon is not installed (or the version is too old). Please follow the instructions on the website https://openrazer.github.io/"
     // If no_systemd: Check if daemon is not running: "It seems you are not using systemd as your init system. You have to find a way to auto-start the daemon yourself."
-    libopenrazer::DaemonStatus daemonStatus = libopenrazer::getDaemonStatus();
+    // Ask systemd right away, the reply is only needed once it's clear whether the daemon is running
+    libopenrazer::PendingReply<libopenrazer::DaemonStatus> daemonStatusReply = libopenrazer::getDaemonStatusAsync();
 
-    // Check if daemon available
-    if(!libopenrazer::isDaemonRunning()) {
-        // Build a UI depending on what the status is.
+    // Check if daemon available. Only asks the bus, so the window doesn't wait for the daemon.
+    if(!libopenrazer::isDaemonRegistered()) {
+        // Build a UI depending on what the status is. There's nothing else to show, so wait for it.
+        libopenrazer::DaemonStatus daemonStatus = daemonStatusReply.value();
 
         if(daemonStatus == libopenrazer::DaemonStatus::NotInstalled) {
             QVBoxLayout *boxLayout = new QVBoxLayout(this);
@@ -89,7 +99,9 @@ RazerGenie::RazerGenie(QWidget *parent) : QWidget(parent)
             QPushButton *issueButton = new QPushButton(tr("Report issue"));
 
             textEdit->setReadOnly(true);
-            textEdit->setText(libopenrazer::getDaemonStatusOutput());
+            libopenrazer::getDaemonStatusOutputAsync().then(textEdit, [textEdit](const QString &output) {
+                textEdit->setText(output);
+            });
 
             gridLayout->addWidget(label, 0, 1, 1, 2);
             gridLayout->addWidget(textEdit, 1, 1, 1, 2);
@@ -105,18 +117,25 @@ RazerGenie::RazerGenie(QWidget *parent) : QWidget(parent)
         // Set up the normal UI
         setupUi();
 
-        if(daemonStatus == libopenrazer::DaemonStatus::Disabled) {
-            QMessageBox msgBox;
-            msgBox.setText(tr("The OpenRazer daemon is not set to auto-start. Click \"Enable\" to use the full potential of the daemon right after login."));
-            QPushButton *enableButton = msgBox.addButton(tr("Enable"), QMessageBox::ActionRole);
-            msgBox.addButton(QMessageBox::Ignore);
+        // Ask to enable the daemon once systemd answered, the window is shown in the meantime
+        daemonStatusReply.then(this, [this](libopenrazer::DaemonStatus daemonStatus) {
+            if(daemonStatus != libopenrazer::DaemonStatus::Disabled) {
+                return;
+            }
+            // Not exec(), a nested event loop inside a reply callback would run further replies from within this one
+            QMessageBox *msgBox = new QMessageBox(this);
+            msgBox->setAttribute(Qt::WA_DeleteOnClose);
+            msgBox->setText(tr("The OpenRazer daemon is not set to auto-start. Click \"Enable\" to use the full potential of the daemon right after login."));
+            QPushButton *enableButton = msgBox->addButton(tr("Enable"), QMessageBox::ActionRole);
+            msgBox->addButton(QMessageBox::Ignore);
+            connect(msgBox, &QMessageBox::buttonClicked, this, [enableButton](QAbstractButton *button) {
+                if (button == enableButton) {
+                    libopenrazer::enableDaemonAsync();
+                } // ignore the cancel button
+            });
             // Show message box
-            msgBox.exec();
-
-            if (msgBox.clickedButton() == enableButton) {
-                libopenrazer::enableDaemon();
-            } // ignore the cancel button
-        }
+            msgBox->open();
+        });
 
         // Watch for dbus service changes (= daemon ends or gets started)
         QDBusServiceWatcher *watcher = new QDBusServiceWatcher("org.razer", QDBusConnection::sessionBus());
@@ -130,29 +149,79 @@ RazerGenie::RazerGenie(QWidget *parent) : QWidget(parent)
 
 RazerGenie::~RazerGenie()
 {
+    // Devices still being created use the cache, the ones not handed over yet are deleted with their job
+    QThreadPool::globalInstance()->waitForDone();
     QHashIterator<QString, libopenrazer::Device*> i(devices);
     while (i.hasNext()) {
         i.next();
         delete i.value();
     }
+    if(deviceCache != NULL) {
+        // Metadata queried later on (e.g. by the custom editor) is only written here
+        deviceCache->save();
+        delete deviceCache;
+    }
+    libopenrazer::stopIoThread();
 }
 
 void RazerGenie::setupUi()
 {
     ui_main.setupUi(this);
 
-    ui_main.versionLabel->setText(tr("Daemon version: %1").arg(libopenrazer::getDaemonVersion()));
+    // Keeps slider changes from waiting behind other calls to the daemon
+    libopenrazer::startIoThread();
+
+    // Send all startup queries at once, the window is shown right away and filled in as the replies arrive
+    libopenrazer::PendingReply<QString> daemonVersion = libopenrazer::getDaemonVersionAsync();
+    libopenrazer::PendingReply<QStringList> connectedDevices = libopenrazer::getConnectedDevicesAsync();
+    libopenrazer::PendingReply<bool> syncEffects = libopenrazer::getSyncEffectsAsync();
+    libopenrazer::PendingReply<bool> offOnScreensaver = libopenrazer::getTurnOffOnScreensaverAsync();
+
+    ui_main.versionLabel->setText(tr("Daemon version: %1").arg("..."));
+    daemonVersion.then(this, [this](const QString &version) {
+        ui_main.versionLabel->setText(tr("Daemon version: %1").arg(version));
+    });
 
-    fillDeviceList();
+    // The daemon answers in order, so the version is known by the time the devices arrive
+    connectedDevices.then(this, [this, daemonVersion](const QStringList &serialnrs) {
+        if(deviceCache == NULL) {
+            deviceCache = new libopenrazer::DeviceCache(deviceCacheFile(), daemonVersion.value());
+        }
+        fillDeviceList(serialnrs);
+    });
 
     //Connect signals
     connect(ui_main.preferencesButton, &QPushButton::pressed, this, &RazerGenie::openPreferences);
     connect(ui_main.syncCheckBox, &QCheckBox::clicked, this, &RazerGenie::toggleSync);
-    ui_main.syncCheckBox->setChecked(libopenrazer::getSyncEffects());
+    ui_main.syncCheckBox->setEnabled(false);
+    syncEffects.then(this, [this](bool on) {
+        ui_main.syncCheckBox->setChecked(on);
+        ui_main.syncCheckBox->setEnabled(true);
+    });
     connect(ui_main.screensaverCheckBox, &QCheckBox::clicked, this, &RazerGenie::toggleOffOnScreesaver);
-    ui_main.screensaverCheckBox->setChecked(libopenrazer::getTurnOffOnScreensaver());
-
-    connect(ui_main.listWidget, &QListWidget::currentRowChanged, ui_main.stackedWidget, &QStackedWidget::setCurrentIndex);
+    ui_main.screensaverCheckBox->setEnabled(false);
+    offOnScreensaver.then(this, [this](bool on) {
+        ui_main.screensaverCheckBox->setChecked(on);
+        ui_main.screensaverCheckBox->setEnabled(true);
+    });
+
+    deviceListModel = new DeviceListModel(this);
+    ui_main.deviceListView->setModel(deviceListModel);
+    ui_main.deviceListView->setItemDelegate(new DeviceListDelegate(ui_main.deviceListView));
+    // All entries have the same height, so the view doesn't have to ask for every one
+    ui_main.deviceListView->setUniformItemSizes(true);
+    connect(ui_main.deviceListView->selectionModel(), &QItemSelectionModel::currentRowChanged, this, [this](const QModelIndex &current) {
+        ui_main.stackedWidget->setCurrentIndex(current.row());
+    });
+    connect(ui_main.stackedWidget, &QStackedWidget::currentChanged, this, &RazerGenie::devicePageChanged);
+
+    // One fetch is shared by all devices of the same model
+    RazerImageDownloader *downloader = RazerImageDownloader::instance();
+    connect(downloader, &RazerImageDownloader::downloadFinished, deviceListModel, &DeviceListModel::setImageFile);
+    connect(downloader, &RazerImageDownloader::downloadErrored, deviceListModel, [this](const QUrl &url, const QString &reason, const QString &longReason) {
+        qDebug() << "RazerGenie: Image download failed:" << reason << longReason;
+        deviceListModel->setImageText(url, reason);
+    });
 
     libopenrazer::connectDeviceAdded(this, SLOT(deviceAdded()));
     libopenrazer::connectDeviceRemoved(this, SLOT(deviceRemoved()));
@@ -161,7 +230,18 @@ void RazerGenie::setupUi()
 void RazerGenie::dbusServiceRegistered(const QString &serviceName)
 {
     qInfo() << "Registered! " << serviceName;
-    fillDeviceList();
+    // Calls failed while the daemon was gone
+    libopenrazer::resetCircuitBreaker();
+    libopenrazer::PendingReply<QString> daemonVersion = libopenrazer::getDaemonVersionAsync();
+    libopenrazer::getConnectedDevicesAsync().then(this, [this, daemonVersion](const QStringList &serialnrs) {
+        // The daemon could have been updated. It answers in order, so the version is known by now.
+        if(deviceCache == NULL) {
+            deviceCache = new libopenrazer::DeviceCache(deviceCacheFile(), daemonVersion.value());
+        } else {
+            deviceCache->setDaemonVersion(daemonVersion.value());
+        }
+        fillDeviceList(serialnrs);
+    });
     util::showInfo(tr("The D-Bus connection was re-established."));
 }
 
@@ -173,50 +253,33 @@ void RazerGenie::dbusServiceUnregistered(const QString &serviceName)
     util::showError(tr("The D-Bus connection was lost, which probably means that the daemon has crashed."));
 }
 
-/**
- * Returns a list of connected devices, which are detected by Linux / lsusb. VID and PID are in decimal form.
- */
-QList<QPair<int, int>> RazerGenie::getConnectedDevices_lsusb()
-{
-    // Get list of Razer devices connected to the PC: lsusb | grep '1532:' | cut -d' ' -f6
-    QProcess process;
-    process.start("bash", QStringList() << "-c" << "lsusb | grep '1532:' | cut -d' ' -f6");
-    process.waitForFinished();
-    QStringList outputList = QString(process.readAllStandardOutput()).split("\n", QString::SkipEmptyParts);
-
-    QList<QPair<int, int>> returnList;
-
-    // Transform the list ["1234:abcd", "5678:def0"] into a QList with QPairs.
-    QStringListIterator i(outputList);
-    while(i.hasNext()) {
-        QStringList split = i.next().split(":");
-        bool ok;
-        //TODO: Check if count is 2? Otherwise SIGSEGV probably
-        int vid = split[0].toInt(&ok, 16);
-        int pid = split[1].toInt(&ok, 16);
-        if(!ok) {
-            qWarning() << "RazerGenie: Error while parsing the lsusb output.";
-            return QList<QPair<int, int>>();
-        }
-        returnList.append(qMakePair(vid, pid));
-    }
-    return returnList;
-}
-
-void RazerGenie::fillDeviceList()
+void RazerGenie::fillDeviceList(const QStringList &serialnrs)
 {
-    // Get all connected devices
-    QStringList serialnrs = libopenrazer::getConnectedDevices();
-
-    // Iterate through all devices
+    // A device can be added by a hotplug signal before the list arrives, or still be created for an earlier list
+    QStringList newSerialnrs;
     foreach (const QString &serial, serialnrs) {
-        addDeviceToGui(serial);
+        if(!devices.contains(serial) && !creatingSerials.contains(serial)) {
+            newSerialnrs.append(serial);
+            creatingSerials.insert(serial);
+        }
     }
 
-    if(serialnrs.size() == 0) {
-        // Add placeholder widget
-        ui_main.stackedWidget->addWidget(getNoDevicePlaceholder());
-    }
+    // Query all devices at once on a worker thread, every device is added as soon as it is set up
+    libopenrazer::Device::createDevicesAsync(newSerialnrs, deviceCache, this, [this](libopenrazer::Device *device) {
+        if(!creatingSerials.remove(device->serial())) {
+            // Removed or the daemon went away in the meantime
+            delete device;
+            return;
+        }
+        addDeviceToGui(device);
+    }, [this]() {
+        if(devices.isEmpty() && creatingSerials.isEmpty()) {
+            showNoDevicePlaceholder();
+        }
+        if(deviceCache != NULL) {
+            deviceCache->save();
+        }
+    });
 }
 
 void RazerGenie::refreshDeviceList()
@@ -228,110 +291,122 @@ void RazerGenie::refreshDeviceList()
     // if still in new, remove from new list
     // if not in new, remove from both
     // go through new (remaining items) list and add
-    QStringList serialnrs = libopenrazer::getConnectedDevices();
-    QMutableHashIterator<QString, libopenrazer::Device*> i(devices);
-    while (i.hasNext()) {
-        i.next();
-        if(serialnrs.contains(i.key())) {
-            qDebug() << "Keep: " << i.key();
-            serialnrs.removeOne(i.key());
-        } else {
-            libopenrazer::Device* dev = i.value();
-            qDebug() << "Remove: " << i.key();
-            serialnrs.removeOne(i.key());
-            removeDeviceFromGui(i.key());
-            devices.remove(i.key());
-            delete dev;
+    libopenrazer::getConnectedDevicesAsync().then(this, [this](QStringList serialnrs) {
+        QMutableHashIterator<QString, libopenrazer::Device*> i(devices);
+        while (i.hasNext()) {
+            i.next();
+            if(serialnrs.contains(i.key())) {
+                qDebug() << "Keep: " << i.key();
+                serialnrs.removeOne(i.key());
+            } else {
+                libopenrazer::Device* dev = i.value();
+                qDebug() << "Remove: " << i.key();
+                serialnrs.removeOne(i.key());
+                // Before removing the page, so the placeholder is shown if it was the last one
+                i.remove();
+                removeDeviceFromGui(dev->serial());
+                delete dev;
+            }
         }
-    }
-    QStringListIterator j(serialnrs);
-    while(j.hasNext()) {
-        QString serial = j.next();
-        qDebug() << "Add: " << serial;
-        addDeviceToGui(serial);
-    }
+        // Devices still being created are dropped once they arrive
+        creatingSerials.intersect(QSet<QString>::fromList(serialnrs));
+        qDebug() << "Add: " << serialnrs;
+        fillDeviceList(serialnrs);
+    });
 }
 
 void RazerGenie::clearDeviceList()
 {
     // Clear devices QHash
     devices.clear();
+    // Devices still being created are dropped once they arrive
+    creatingSerials.clear();
+    builtPages.clear();
     // Clear device list
-    ui_main.listWidget->clear();
+    deviceListModel->clear();
     // Clear stackedwidget
-    for(int i = ui_main.stackedWidget->count(); i >= 0; i--) {
+    for(int i = ui_main.stackedWidget->count() - 1; i >= 0; i--) {
         QWidget* widget = ui_main.stackedWidget->widget(i);
         ui_main.stackedWidget->removeWidget(widget);
-        widget->deleteLater();
+        // The placeholder is reused
+        if(widget != noDevicePlaceholder) {
+            widget->deleteLater();
+        }
     }
     // Add placeholder widget
     // TODO: Add placeholder widget with crash information and link to bug report?
-    ui_main.stackedWidget->addWidget(getNoDevicePlaceholder());
+    showNoDevicePlaceholder();
 }
 
-void RazerGenie::addDeviceToGui(const QString &serial)
+void RazerGenie::addDeviceToGui(libopenrazer::Device *currentDevice)
 {
-    // Create device instance with current serial
-    libopenrazer::Device *currentDevice = new libopenrazer::Device(serial);
-
     // Setup variables for easy access
-    QString type = currentDevice->getDeviceType();
+    QString serial = currentDevice->serial();
     QString name = currentDevice->getDeviceName();
 
     qDebug() << serial;
     qDebug() << name;
 
-    if(devices.isEmpty()) {
-        // Remove placeholder widget if inserted.
-        ui_main.stackedWidget->removeWidget(ui_main.stackedWidget->widget(0));
+    // Remove placeholder widget if inserted.
+    if(noDevicePlaceholder != NULL) {
+        ui_main.stackedWidget->removeWidget(noDevicePlaceholder);
     }
 
-//     qDebug() << "Width" << ui_main.listWidget->width();
-//     qDebug() << "Height" << ui_main.listWidget->height();
-
     // Add new device to the list
-    QListWidgetItem *listItem = new QListWidgetItem();
-    listItem->setSizeHint(QSize(listItem->sizeHint().width(), 120));
-    ui_main.listWidget->addItem(listItem);
-    DeviceListWidget *listItemWidget = new DeviceListWidget(ui_main.listWidget, currentDevice);
-    ui_main.listWidget->setItemWidget(listItem, listItemWidget);
+    deviceListModel->addDevice(currentDevice);
 
     // Insert current device pointer with serial lookup into a QHash
     devices.insert(serial, currentDevice);
 
-    // Download image for device
+    // Download image for device, the model already shows a placeholder
     if(!currentDevice->getPngFilename().isEmpty()) {
-        RazerImageDownloader *dl = new RazerImageDownloader(QUrl(currentDevice->getPngUrl()), this);
-        connect(dl, &RazerImageDownloader::downloadFinished, listItemWidget, &DeviceListWidget::imageDownloaded);
-        connect(dl, &RazerImageDownloader::downloadErrored, listItemWidget, &DeviceListWidget::imageDownloadErrored);
-        dl->startDownload();
+        RazerImageDownloader::instance()->fetch(QUrl(currentDevice->getPngUrl()));
     } else {
         qWarning() << ".png mapping for device '" + currentDevice->getDeviceName() + "' (PID "+QString::number(currentDevice->getPid())+") missing.";
-        listItemWidget->setNoImage();
     }
 
+    // Only an empty page for now, it's built once the device is shown, see devicePageChanged()
+    ui_main.stackedWidget->addWidget(new RazerDeviceWidget(name, serial));
+}
+
+/**
+ * Builds the page of the device with the serial of \a widget into it.
+ * The settings are taken from the property model of the device, which only queries the daemon for values it doesn't know yet.
+ */
+void RazerGenie::buildDevicePage(RazerDeviceWidget *widget)
+{
+    libopenrazer::Device *currentDevice = devices.value(widget->getSerial());
+    if(currentDevice == NULL) {
+        return;
+    }
+    QString serial = currentDevice->serial();
+    // Current settings, shared with the rest of the UI
+    libopenrazer::DeviceProperties *properties = currentDevice->properties();
+    // Both were fetched when the device was created
+    QString type = currentDevice->getDeviceType();
+    QString name = currentDevice->getDeviceName();
+
     // Types known for now: headset, mouse, mug, keyboard, tartarus, core, orbweaver
     qDebug() << type;
 
-    /* Create actual DeviceWidget */
-    RazerDeviceWidget *widget = new RazerDeviceWidget(name, serial);
-
     QVBoxLayout *verticalLayout = new QVBoxLayout(widget);
+    // Kept with the page, so the slots don't have to look up the widgets
+    DeviceControls &controls = widget->controls();
 
     // List of locations to iterate through
     QList<libopenrazer::Device::LightingLocation> lightingLocationsTodo;
 
     // Check what lighting locations the device has
-    if(currentDevice->hasCapability("lighting") ||
-       currentDevice->hasCapability("lighting_bw2013") ||
-       currentDevice->hasCapability("lighting_profile_leds") ||
-       currentDevice->hasCapability("brightness"))
+    if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING) ||
+       currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_BW2013) ||
+       currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_PROFILE_LEDS) ||
+       currentDevice->hasCapability(libopenrazer::CAP_BRIGHTNESS))
         lightingLocationsTodo.append(libopenrazer::Device::Lighting);
-    if(currentDevice->hasCapability("lighting_logo"))
+    if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_LOGO))
         lightingLocationsTodo.append(libopenrazer::Device::LightingLogo);
-    if(currentDevice->hasCapability("lighting_scroll"))
+    if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_SCROLL))
         lightingLocationsTodo.append(libopenrazer::Device::LightingScroll);
-    if(currentDevice->hasCapability("lighting_backlight"))
+    if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_BACKLIGHT))
         lightingLocationsTodo.append(libopenrazer::Device::LightingBacklight);
 
     // Declare header font
@@ -376,11 +451,12 @@ void RazerGenie::addDeviceToGui(const QString &serial)
         verticalLayout->addWidget(lightingLocationLabel);
         verticalLayout->addLayout(lightingHBox);
 
+        ZoneControls &zone = controls.zones[currentLocation];
         QComboBox *comboBox = new QComboBox;
         QLabel *brightnessLabel = NULL;
         QSlider *brightnessSlider = NULL;
 
-        comboBox->setObjectName(QString::number(currentLocation));
+        zone.comboBox = comboBox;
         qDebug() << "CURRENT LOCATION: " << QString::number(currentLocation);
         //TODO More elegant solution instead of the sizePolicy?
         comboBox->setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed));
@@ -388,24 +464,27 @@ void RazerGenie::addDeviceToGui(const QString &serial)
         //TODO Battery
         //TODO Sync effects in comboboxes & colorStuff when the sync checkbox is active
 
-        if(currentLocation == libopenrazer::Device::Lighting) {
-            // Add items from capabilities
-            for(int i=0; i<libopenrazer::lightingComboBoxCapabilites.size(); i++) {
-                if(currentDevice->hasCapability(libopenrazer::lightingComboBoxCapabilites[i].getIdentifier())) {
-                    comboBox->addItem(libopenrazer::lightingComboBoxCapabilites[i].getDisplayString(), QVariant::fromValue(libopenrazer::lightingComboBoxCapabilites[i]));
-                }
+        // Add the effects of this location the device supports, with their index in the registry
+        for(int i=0; i<libopenrazer::effectCount; i++) {
+            const libopenrazer::Effect &effect = libopenrazer::effects[i];
+            if(effect.location == currentLocation && currentDevice->hasCapability(effect.capability)) {
+                comboBox->addItem(effect.displayString, i);
             }
+        }
 
+        if(currentLocation == libopenrazer::Device::Lighting) {
             // Connect signal from combobox
             connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RazerGenie::standardCombo);
 
             // Brightness slider
-            if(currentDevice->hasCapability("brightness")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_BRIGHTNESS)) {
                 brightnessLabel = new QLabel(tr("Brightness"));
                 brightnessSlider = new QSlider(Qt::Horizontal, widget);
-                if(currentDevice->hasCapability("get_brightness")) {
-                    qDebug() << "Brightness:" << currentDevice->getBrightness();
-                    brightnessSlider->setValue(currentDevice->getBrightness());
+                if(currentDevice->hasCapability(libopenrazer::CAP_GET_BRIGHTNESS)) {
+                    showProperty(properties, libopenrazer::DeviceProperties::Brightness, brightnessSlider, [brightnessSlider](const QVariant &brightness) {
+                        qDebug() << "Brightness:" << brightness.toDouble();
+                        brightnessSlider->setValue(brightness.toDouble());
+                    });
                 } else {
                     // Set the slider to 100 by default as it's more likely it's 100 than 0...
                     brightnessSlider->setValue(100);
@@ -414,22 +493,17 @@ void RazerGenie::addDeviceToGui(const QString &serial)
             }
 
         } else if(currentLocation == libopenrazer::Device::LightingLogo) {
-            // Add items from capabilities
-            for(int i=0; i<libopenrazer::logoComboBoxCapabilites.size(); i++) {
-                if(currentDevice->hasCapability(libopenrazer::logoComboBoxCapabilites[i].getIdentifier())) {
-                    comboBox->addItem(libopenrazer::logoComboBoxCapabilites[i].getDisplayString(), QVariant::fromValue(libopenrazer::logoComboBoxCapabilites[i]));
-                }
-            }
-
             // Connect signal from combobox
             connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RazerGenie::logoCombo);
 
             // Brightness slider
-            if(currentDevice->hasCapability("lighting_logo_brightness")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_LOGO_BRIGHTNESS)) {
                 brightnessLabel = new QLabel(tr("Brightness Logo"));
                 brightnessSlider = new QSlider(Qt::Horizontal, widget);
-                if(currentDevice->hasCapability("get_lighting_logo_brightness")) {
-                    brightnessSlider->setValue(currentDevice->getLogoBrightness());
+                if(currentDevice->hasCapability(libopenrazer::CAP_GET_LIGHTING_LOGO_BRIGHTNESS)) {
+                    showProperty(properties, libopenrazer::DeviceProperties::LogoBrightness, brightnessSlider, [brightnessSlider](const QVariant &brightness) {
+                        brightnessSlider->setValue(brightness.toDouble());
+                    });
                 } else {
                     // Set the slider to 100 by default as it's more likely it's 100 than 0...
                     brightnessSlider->setValue(100);
@@ -438,22 +512,17 @@ void RazerGenie::addDeviceToGui(const QString &serial)
             }
 
         } else if(currentLocation == libopenrazer::Device::LightingScroll) {
-            // Add items from capabilities
-            for(int i=0; i<libopenrazer::scrollComboBoxCapabilites.size(); i++) {
-                if(currentDevice->hasCapability(libopenrazer::scrollComboBoxCapabilites[i].getIdentifier())) {
-                    comboBox->addItem(libopenrazer::scrollComboBoxCapabilites[i].getDisplayString(), QVariant::fromValue(libopenrazer::scrollComboBoxCapabilites[i]));
-                }
-            }
-
             // Connect signal from combobox
             connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RazerGenie::scrollCombo);
 
             // Brightness slider
-            if(currentDevice->hasCapability("lighting_scroll_brightness")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_SCROLL_BRIGHTNESS)) {
                 brightnessLabel = new QLabel(tr("Brightness Scroll"));
                 brightnessSlider = new QSlider(Qt::Horizontal, widget);
-                if(currentDevice->hasCapability("get_lighting_scroll_brightness")) {
-                    brightnessSlider->setValue(currentDevice->getScrollBrightness());
+                if(currentDevice->hasCapability(libopenrazer::CAP_GET_LIGHTING_SCROLL_BRIGHTNESS)) {
+                    showProperty(properties, libopenrazer::DeviceProperties::ScrollBrightness, brightnessSlider, [brightnessSlider](const QVariant &brightness) {
+                        brightnessSlider->setValue(brightness.toDouble());
+                    });
                 } else {
                     // Set the slider to 100 by default as it's more likely it's 100 than 0...
                     brightnessSlider->setValue(100);
@@ -461,22 +530,17 @@ void RazerGenie::addDeviceToGui(const QString &serial)
                 connect(brightnessSlider, &QSlider::valueChanged, this, &RazerGenie::scrollBrightnessChanged);
             }
         } else if(currentLocation == libopenrazer::Device::LightingBacklight) {
-            // Add items from capabilities
-            for(int i=0; i<libopenrazer::backlightComboBoxCapabilites.size(); i++) {
-                if(currentDevice->hasCapability(libopenrazer::backlightComboBoxCapabilites[i].getIdentifier())) {
-                    comboBox->addItem(libopenrazer::backlightComboBoxCapabilites[i].getDisplayString(), QVariant::fromValue(libopenrazer::backlightComboBoxCapabilites[i]));
-                }
-            }
-
             // Connect signal from combobox
             connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RazerGenie::backlightCombo);
 
             // Brightness slider
-            if(currentDevice->hasCapability("lighting_backlight_brightness")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_BACKLIGHT_BRIGHTNESS)) {
                 brightnessLabel = new QLabel(tr("Brightness Backlight"));
                 brightnessSlider = new QSlider(Qt::Horizontal, widget);
-                if(currentDevice->hasCapability("get_lighting_backlight_brightness")) {
-                    brightnessSlider->setValue(currentDevice->getBacklightBrightness());
+                if(currentDevice->hasCapability(libopenrazer::CAP_GET_LIGHTING_BACKLIGHT_BRIGHTNESS)) {
+                    showProperty(properties, libopenrazer::DeviceProperties::BacklightBrightness, brightnessSlider, [brightnessSlider](const QVariant &brightness) {
+                        brightnessSlider->setValue(brightness.toDouble());
+                    });
                 } else {
                     // Set the slider to 100 by default as it's more likely it's 100 than 0...
                     brightnessSlider->setValue(100);
@@ -499,11 +563,11 @@ void RazerGenie::addDeviceToGui(const QString &serial)
                 colorButton->setFlat(true);
                 colorButton->setPalette(pal);
                 colorButton->setMaximumWidth(70);
-                colorButton->setObjectName(QString::number(currentLocation) + "_colorbutton" + QString::number(i));
+                zone.colorButtons[i-1] = colorButton;
                 lightingHBox->addWidget(colorButton);
 
-                libopenrazer::RazerCapability capability = comboBox->currentData().value<libopenrazer::RazerCapability>();
-                if(capability.getNumColors() < i)
+                const libopenrazer::Effect &effect = libopenrazer::effects[comboBox->currentData().toInt()];
+                if(effect.numColors < i)
                     colorButton->hide();
                 connect(colorButton, &QPushButton::clicked, this, &RazerGenie::colorButtonClicked);
             }
@@ -516,9 +580,12 @@ void RazerGenie::addDeviceToGui(const QString &serial)
                 else
                     name = tr("Right");
                 QRadioButton *radio = new QRadioButton(name, widget);
-                radio->setObjectName(QString::number(currentLocation) + "_radiobutton" + QString::number(i));
-                if(i==1) // set the 'left' checkbox to activated
+                if(i==1) { // set the 'left' checkbox to activated
                     radio->setChecked(true);
+                    zone.waveLeft = radio;
+                } else {
+                    zone.waveRight = radio;
+                }
                 // hide by default
                 radio->hide();
                 lightingHBox->addWidget(radio);
@@ -537,9 +604,11 @@ void RazerGenie::addDeviceToGui(const QString &serial)
         /* 'Set Logo Active' checkbox */
         if(currentLocation == libopenrazer::Device::LightingLogo) {
             // Show if the device has 'setActive' but not 'setNone' as it would be basically a duplicate action
-            if(currentDevice->hasCapability("lighting_logo_active") && !currentDevice->hasCapability("lighting_logo_none")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_LOGO_ACTIVE) && !currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_LOGO_NONE)) {
                 QCheckBox *activeCheckbox = new QCheckBox(tr("Set Logo Active"), widget);
-                activeCheckbox->setChecked(currentDevice->getLogoActive());
+                showProperty(properties, libopenrazer::DeviceProperties::LogoActive, activeCheckbox, [activeCheckbox](const QVariant &active) {
+                    activeCheckbox->setChecked(active.toBool());
+                });
                 verticalLayout->addWidget(activeCheckbox);
                 connect(activeCheckbox, &QCheckBox::clicked, this, &RazerGenie::logoActiveCheckbox);
             }
@@ -548,9 +617,11 @@ void RazerGenie::addDeviceToGui(const QString &serial)
         /* 'Set Scroll Active' checkbox */
         if(currentLocation == libopenrazer::Device::LightingScroll) {
             // Show if the device has 'setActive' but not 'setNone' as it would be basically a duplicate action
-            if(currentDevice->hasCapability("lighting_scroll_active") && !currentDevice->hasCapability("lighting_scroll_none")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_SCROLL_ACTIVE) && !currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_SCROLL_NONE)) {
                 QCheckBox *activeCheckbox = new QCheckBox(tr("Set Scroll Active"), widget);
-                activeCheckbox->setChecked(currentDevice->getScrollActive());
+                showProperty(properties, libopenrazer::DeviceProperties::ScrollActive, activeCheckbox, [activeCheckbox](const QVariant &active) {
+                    activeCheckbox->setChecked(active.toBool());
+                });
                 verticalLayout->addWidget(activeCheckbox);
                 connect(activeCheckbox, &QCheckBox::clicked, this, &RazerGenie::scrollActiveCheckbox);
             }
@@ -558,10 +629,12 @@ void RazerGenie::addDeviceToGui(const QString &serial)
 
         /* 'Set Backlight Active' checkbox */
         if(currentLocation == libopenrazer::Device::LightingBacklight) {
-            // Show if the device has 'setActive' but not 'setNone' as it would be basically a duplicate action
-            if(currentDevice->hasCapability("lighting_backlight_active") && !currentDevice->hasCapability("lighting_backlight_none")) {
+            // Unlike logo and scroll there is no 'setBacklightNone' in the daemon that would duplicate this action
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_BACKLIGHT_ACTIVE)) {
                 QCheckBox *activeCheckbox = new QCheckBox(tr("Set Backlight Active"), widget);
-                activeCheckbox->setChecked(currentDevice->getBacklightActive());
+                showProperty(properties, libopenrazer::DeviceProperties::BacklightActive, activeCheckbox, [activeCheckbox](const QVariant &active) {
+                    activeCheckbox->setChecked(active.toBool());
+                });
                 verticalLayout->addWidget(activeCheckbox);
                 connect(activeCheckbox, &QCheckBox::clicked, this, &RazerGenie::backlightActiveCheckbox);
             }
@@ -569,16 +642,17 @@ void RazerGenie::addDeviceToGui(const QString &serial)
 
         /* Profile LED checkboxes */
         if(currentLocation == libopenrazer::Device::Lighting) {
-            if(currentDevice->hasCapability("lighting_profile_leds")) {
+            if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_PROFILE_LEDS)) {
                 for(int i=1; i<=3; ++i) {
                     QString i_str = QString::number(i);
                     QCheckBox *profileLedCheckbox = new QCheckBox(tr("Profile LED %1").arg(i_str), widget);
-                    bool enabled = false;
-                    if(i == 1) enabled = currentDevice->getRedLED();
-                    else if(i == 2) enabled = currentDevice->getGreenLED();
-                    else if(i == 3) enabled = currentDevice->getBlueLED();
-                    profileLedCheckbox->setChecked(enabled);
-                    profileLedCheckbox->setObjectName(i_str);
+                    libopenrazer::DeviceProperties::Property led = libopenrazer::DeviceProperties::RedLED;
+                    if(i == 2) led = libopenrazer::DeviceProperties::GreenLED;
+                    else if(i == 3) led = libopenrazer::DeviceProperties::BlueLED;
+                    showProperty(properties, led, profileLedCheckbox, [profileLedCheckbox](const QVariant &enabled) {
+                        profileLedCheckbox->setChecked(enabled.toBool());
+                    });
+                    controls.profileLeds[i-1] = profileLedCheckbox;
                     verticalLayout->addWidget(profileLedCheckbox);
                     connect(profileLedCheckbox, &QCheckBox::clicked, this, &RazerGenie::profileLedCheckbox);
                 }
@@ -597,7 +671,7 @@ void RazerGenie::addDeviceToGui(const QString &serial)
     }
 
     /* DPI sliders */
-    if(currentDevice->hasCapability("dpi") && !currentDevice->hasCapability("available_dpi")) {
+    if(currentDevice->hasCapability(libopenrazer::CAP_DPI) && !currentDevice->hasCapability(libopenrazer::CAP_AVAILABLE_DPI)) {
         // HBoxes
         QHBoxLayout *dpiXHBox = new QHBoxLayout();
         QHBoxLayout *dpiYHBox = new QHBoxLayout();
@@ -621,37 +695,44 @@ void RazerGenie::addDeviceToGui(const QString &serial)
         dpiYText->setMaximumWidth(60);
         dpiXText->setMaximumHeight(30);
         dpiYText->setMaximumHeight(30);
-        dpiXText->setObjectName("dpiXText");
-        dpiYText->setObjectName("dpiYText");
+        controls.dpiXText = dpiXText;
+        controls.dpiYText = dpiYText;
         dpiXText->setEnabled(false);
         dpiYText->setEnabled(false);
 
         // Sliders
         QSlider *dpiXSlider = new QSlider(Qt::Horizontal, widget);
         QSlider *dpiYSlider = new QSlider(Qt::Horizontal, widget);
-        dpiXSlider->setObjectName("dpiX");
-        dpiYSlider->setObjectName("dpiY");
+        controls.dpiX = dpiXSlider;
+        controls.dpiY = dpiYSlider;
 
         // Sync checkbox
         QLabel *dpiSyncLabel = new QLabel(tr("Lock X/Y"), widget);
         QCheckBox *dpiSyncCheckbox = new QCheckBox(widget);
 
-        // Get the current DPI and set the slider&text
-        QList<int> currDPI = currentDevice->getDPI();
-        qDebug() << "currDPI:" << currDPI;
-        if(currDPI.count() == 2) {
-            dpiXSlider->setValue(currDPI[0]/100);
-            dpiYSlider->setValue(currDPI[1]/100);
-            dpiXText->setText(QString::number(currDPI[0]));
-            dpiYText->setText(QString::number(currDPI[1]));
-        } else {
-            qWarning() << "RazerGenie: Skipping dpi because return value of getDPI() is wrong. Probably the broken fake driver.";
-        }
-
-        int maxDPI = currentDevice->maxDPI();
-        qDebug() << "maxDPI:" << maxDPI;
-        dpiXSlider->setMaximum(maxDPI/100);
-        dpiYSlider->setMaximum(maxDPI/100);
+        // The maximum has to be set before the current DPI, the sliders would clamp it otherwise
+        currentDevice->maxDPIAsync().then(widget, [properties, dpiXSlider, dpiYSlider, dpiXText, dpiYText](int maxDPI) {
+            qDebug() << "maxDPI:" << maxDPI;
+            QSignalBlocker blockerX(dpiXSlider);
+            QSignalBlocker blockerY(dpiYSlider);
+            dpiXSlider->setMaximum(maxDPI/100);
+            dpiYSlider->setMaximum(maxDPI/100);
+
+            // Get the current DPI and set the slider&text
+            showProperty(properties, libopenrazer::DeviceProperties::DPI, dpiXSlider, [dpiXSlider, dpiYSlider, dpiXText, dpiYText](const QVariant &value) {
+                QList<int> currDPI = value.value<QList<int>>();
+                qDebug() << "currDPI:" << currDPI;
+                if(currDPI.count() == 2) {
+                    QSignalBlocker blockerY(dpiYSlider);
+                    dpiXSlider->setValue(currDPI[0]/100);
+                    dpiYSlider->setValue(currDPI[1]/100);
+                    dpiXText->setText(QString::number(currDPI[0]));
+                    dpiYText->setText(QString::number(currDPI[1]));
+                } else {
+                    qWarning() << "RazerGenie: Skipping dpi because return value of getDPI() is wrong. Probably the broken fake driver.";
+                }
+            });
+        });
 
         dpiXSlider->setTickInterval(10);
         dpiYSlider->setTickInterval(10);
@@ -682,24 +763,31 @@ void RazerGenie::addDeviceToGui(const QString &serial)
     }
 
     /* DPI dropdown */
-    if(currentDevice->hasCapability("dpi") && currentDevice->hasCapability("available_dpi")) {
+    if(currentDevice->hasCapability(libopenrazer::CAP_DPI) && currentDevice->hasCapability(libopenrazer::CAP_AVAILABLE_DPI)) {
         QLabel *dpiHeader = new QLabel(tr("DPI"), widget);
         dpiHeader->setFont(headerFont);
         verticalLayout->addWidget(dpiHeader);
 
         QComboBox *dpiComboBox = new QComboBox;
-        QList<int> availableDPI = currentDevice->availableDPI();
-        foreach(int dpivalue, availableDPI) {
-            dpiComboBox->addItem(QString("%1 DPI").arg(dpivalue), dpivalue);
-        }
-        dpiComboBox->setCurrentText(QString("%1 DPI").arg(currentDevice->getDPI()[0]));
+        currentDevice->availableDPIAsync().then(dpiComboBox, [properties, dpiComboBox](const QList<int> &availableDPI) {
+            QSignalBlocker blocker(dpiComboBox);
+            foreach(int dpivalue, availableDPI) {
+                dpiComboBox->addItem(QString("%1 DPI").arg(dpivalue), dpivalue);
+            }
+            showProperty(properties, libopenrazer::DeviceProperties::DPI, dpiComboBox, [dpiComboBox](const QVariant &value) {
+                QList<int> currDPI = value.value<QList<int>>();
+                if(!currDPI.isEmpty()) {
+                    dpiComboBox->setCurrentText(QString("%1 DPI").arg(currDPI[0]));
+                }
+            });
+        });
         verticalLayout->addWidget(dpiComboBox);
 
         connect(dpiComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RazerGenie::dpiComboChanged);
     }
 
     /* Poll rate */
-    if(currentDevice->hasCapability("poll_rate")) {
+    if(currentDevice->hasCapability(libopenrazer::CAP_POLL_RATE)) {
         QLabel *pollRateHeader = new QLabel(tr("Polling rate"), widget);
         pollRateHeader->setFont(headerFont);
         verticalLayout->addWidget(pollRateHeader);
@@ -708,14 +796,16 @@ void RazerGenie::addDeviceToGui(const QString &serial)
         pollComboBox->addItem("125 Hz", libopenrazer::POLL_125HZ);
         pollComboBox->addItem("500 Hz", libopenrazer::POLL_500HZ);
         pollComboBox->addItem("1000 Hz", libopenrazer::POLL_1000HZ);
-        pollComboBox->setCurrentText(QString::number(currentDevice->getPollRate()) + " Hz");
+        showProperty(properties, libopenrazer::DeviceProperties::PollRate, pollComboBox, [pollComboBox](const QVariant &pollRate) {
+            pollComboBox->setCurrentText(QString::number(pollRate.toInt()) + " Hz");
+        });
         verticalLayout->addWidget(pollComboBox);
 
         connect(pollComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &RazerGenie::pollCombo);
     }
 
     /* Custom lighting */
-    if(currentDevice->hasCapability("lighting_led_matrix")) {
+    if(currentDevice->hasCapability(libopenrazer::CAP_LIGHTING_LED_MATRIX)) {
         QPushButton *button = new QPushButton(widget);
         button->setText(tr("Open custom editor"));
         verticalLayout->addWidget(button);
@@ -736,40 +826,90 @@ void RazerGenie::addDeviceToGui(const QString &serial)
     QLabel *serialLabel = new QLabel(tr("Serial number: %1").arg(serial));
     verticalLayout->addWidget(serialLabel);
 
-    QLabel *fwVerLabel = new QLabel(tr("Firmware version: %1").arg(currentDevice->getFirmwareVersion()));
+    QLabel *fwVerLabel = new QLabel(tr("Firmware version: %1").arg("..."));
     verticalLayout->addWidget(fwVerLabel);
-
-    ui_main.stackedWidget->addWidget(widget);
-//         qDebug() << "Stacked widget count:" << ui_main.stackedWidget->count();
+    currentDevice->getFirmwareVersionAsync().then(fwVerLabel, [fwVerLabel](const QString &version) {
+        fwVerLabel->setText(tr("Firmware version: %1").arg(version));
+    });
 }
 
-bool RazerGenie::removeDeviceFromGui(const QString &serial)
+/**
+ * Shows the value of \a property in \a control with \a apply once it is known, and again whenever it changes.
+ * Unknown values are fetched in the background, so building a page doesn't wait for the daemon. The signals of \a control are blocked meanwhile, so showing a value doesn't set it again.
+ */
+void RazerGenie::showProperty(libopenrazer::DeviceProperties *properties, libopenrazer::DeviceProperties::Property property, QWidget *control, const std::function<void(const QVariant &)> &apply)
 {
-    int index = -1;
-    for(int i=0; i<ui_main.listWidget->count(); i++) {
-        // get item for index
-        QListWidgetItem *item = ui_main.listWidget->item(i);
-        // get itemwidget for the item
-        DeviceListWidget *widget = dynamic_cast<DeviceListWidget*>(ui_main.listWidget->itemWidget(item));
-        // compare serial
-        if(widget->device()->serial() == serial) {
-            index = i;
-            break;
+    std::function<void(const QVariant &)> show = [control, apply](const QVariant &value) {
+        QSignalBlocker blocker(control);
+        apply(value);
+    };
+    connect(properties, &libopenrazer::DeviceProperties::valueChanged, control, [property, show](libopenrazer::DeviceProperties::Property changed, const QVariant &value) {
+        if(changed == property) {
+            show(value);
         }
+    });
+    if(properties->contains(property)) {
+        show(properties->value(property));
+    } else {
+        properties->refresh(property);
     }
+}
+
+/**
+ * Builds the device page at \a index if it's shown for the first time (or again after it was recycled).
+ * Only the last few shown pages are kept, the others are replaced by empty pages again.
+ */
+void RazerGenie::devicePageChanged(int index)
+{
+    RazerDeviceWidget *page = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->widget(index));
+    if(page == NULL) {
+        return;
+    }
+    if(page->layout() == NULL) {
+        buildDevicePage(page);
+    }
+    builtPages.removeOne(page);
+    builtPages.append(page);
+
+    while(builtPages.size() > maxBuiltPages) {
+        RazerDeviceWidget *oldPage = builtPages.takeFirst();
+        int oldIndex = ui_main.stackedWidget->indexOf(oldPage);
+        ui_main.stackedWidget->insertWidget(oldIndex, new RazerDeviceWidget(oldPage->getName(), oldPage->getSerial()));
+        ui_main.stackedWidget->removeWidget(oldPage);
+        oldPage->deleteLater();
+    }
+}
+
+bool RazerGenie::removeDeviceFromGui(const QString &serial)
+{
+    int index = deviceListModel->indexOf(serial);
     if(index == -1) {
         return false;
     }
-    ui_main.stackedWidget->removeWidget(ui_main.stackedWidget->widget(index));
-    delete ui_main.listWidget->takeItem(index);
+    QWidget *page = ui_main.stackedWidget->widget(index);
+    builtPages.removeOne(static_cast<RazerDeviceWidget*>(page));
+    ui_main.stackedWidget->removeWidget(page);
+    page->deleteLater();
+    deviceListModel->removeDevice(index);
 
     // Add placeholder widget if the stackedWidget is empty after removing.
     if(devices.isEmpty()) {
-        ui_main.stackedWidget->addWidget(getNoDevicePlaceholder());
+        showNoDevicePlaceholder();
     }
     return true;
 }
 
+/**
+ * Shows the placeholder page for when no device is connected, unless it is shown already.
+ */
+void RazerGenie::showNoDevicePlaceholder()
+{
+    QWidget *placeholder = getNoDevicePlaceholder();
+    if(ui_main.stackedWidget->indexOf(placeholder) == -1) {
+        ui_main.stackedWidget->addWidget(placeholder);
+    }
+}
+
 QWidget *RazerGenie::getNoDevicePlaceholder()
 {
     if(noDevicePlaceholder != NULL) {
@@ -777,60 +917,17 @@ QWidget *RazerGenie::getNoDevicePlaceholder()
     }
     // Generate placeholder widget with text "No device is connected.". Maybe add a usb pid check - at least add link to readme and troubleshooting page. Maybe add support for the future daemon troubleshooting option.
 
-    QList<QPair<int, int>> connectedDevices = getConnectedDevices_lsusb();
-    QList<QPair<int, int>> matches;
-
-    // Don't even iterate if there are no devices detected by lsusb.
-    if(connectedDevices.count() != 0) {
-        QHashIterator<QString, QVariant> i(libopenrazer::getSupportedDevices());
-        // Iterate through the supported devices
-        while (i.hasNext()) {
-            i.next();
-            QList<QVariant> list = i.value().toList();
-            if(list.count() != 2) {
-                qWarning() << "RazerGenie: Error while iterating through supportedDevices";
-                qWarning() << list;
-                continue;
-            }
-            int vid = list[0].toInt();
-            int pid = list[1].toInt();
-
-            QListIterator<QPair<int, int>> j(connectedDevices);
-            while (j.hasNext()) {
-                QPair<int, int> x = j.next();
-                if(x.first == vid && x.second == pid) {
-                    qDebug() << "Found a device match!";
-                    matches.append(x);
-                }
-            }
-        }
-    }
-
     noDevicePlaceholder = new QWidget();
     QVBoxLayout *boxLayout = new QVBoxLayout(noDevicePlaceholder);
     boxLayout->setAlignment(Qt::AlignTop);
 
     QFont headerFont("Arial", 15, QFont::Bold);
-    QLabel *headerLabel;
-    QLabel *textLabel;
-    QPushButton *button1;
-    QPushButton *button2;
-    if(matches.size() == 0) {
-        headerLabel = new QLabel(tr("No device was detected"));
-        textLabel = new QLabel(tr("The OpenRazer daemon didn't detect a device that is supported.\nThis could also be caused due to a misconfiguration of this PC."));
-        button1 = new QPushButton(tr("Open supported devices"));
-        connect(button1, &QPushButton::pressed, this, &RazerGenie::openSupportedDevicesUrl);
-        button2 = new QPushButton(tr("Report issue"));
-        connect(button2, &QPushButton::pressed, this, &RazerGenie::openIssueUrl);
-    } else {
-        headerLabel = new QLabel(tr("The daemon didn't detect a device that is connected"));
-        textLabel = new QLabel(tr("Linux detected connected devices but the daemon didn't. This could be either due to a permission problem or a kernel module problem."));
-        qDebug() << matches;
-        button1 = new QPushButton(tr("Open troubleshooting page"));
-        connect(button1, &QPushButton::pressed, this, &RazerGenie::openTroubleshootingUrl);
-        button2 = new QPushButton(tr("Report issue"));
-        connect(button2, &QPushButton::pressed, this, &RazerGenie::openIssueUrl);
-    }
+    QLabel *headerLabel = new QLabel(tr("No device was detected"));
+    QLabel *textLabel = new QLabel(tr("The OpenRazer daemon didn't detect a device that is supported.\nThis could also be caused due to a misconfiguration of this PC."));
+    QPushButton *button1 = new QPushButton(tr("Open supported devices"));
+    connect(button1, &QPushButton::pressed, this, &RazerGenie::openSupportedDevicesUrl);
+    QPushButton *button2 = new QPushButton(tr("Report issue"));
+    connect(button2, &QPushButton::pressed, this, &RazerGenie::openIssueUrl);
     headerLabel->setFont(headerFont);
 
     boxLayout->addWidget(headerLabel);
@@ -839,19 +936,48 @@ QWidget *RazerGenie::getNoDevicePlaceholder()
     hbox->addWidget(button1);
     hbox->addWidget(button2);
     boxLayout->addLayout(hbox);
+
+    // Don't even ask the daemon if Linux didn't detect any devices.
+    QList<libopenrazer::UsbId> connectedDevices = libopenrazer::getConnectedUsbDevices();
+    if(connectedDevices.count() != 0) {
+        // The texts are changed once the daemon answered, the page is shown in the meantime
+        libopenrazer::getSupportedDevicesAsync().then(noDevicePlaceholder, [this, connectedDevices, headerLabel, textLabel, button1](const QVariantHash &supported) {
+            libopenrazer::SupportedDeviceIndex supportedDevices(supported);
+            QList<libopenrazer::UsbId> matches;
+            foreach(const libopenrazer::UsbId &device, connectedDevices) {
+                if(supportedDevices.contains(device.first, device.second)) {
+                    qDebug() << "Found a device match!";
+                    matches.append(device);
+                }
+            }
+            if(matches.size() == 0) {
+                return;
+            }
+            headerLabel->setText(tr("The daemon didn't detect a device that is connected"));
+            textLabel->setText(tr("Linux detected connected devices but the daemon didn't. This could be either due to a permission problem or a kernel module problem."));
+            qDebug() << matches;
+            button1->setText(tr("Open troubleshooting page"));
+            disconnect(button1, &QPushButton::pressed, this, &RazerGenie::openSupportedDevicesUrl);
+            connect(button1, &QPushButton::pressed, this, &RazerGenie::openTroubleshootingUrl);
+        });
+    }
     return noDevicePlaceholder;
 }
 
 void RazerGenie::toggleSync(bool sync)
 {
-    if(!libopenrazer::syncEffects(sync))
-        util::showError(tr("Error while syncing devices."));
+    libopenrazer::syncEffectsAsync(sync).then(this, [](bool success) {
+        if(!success)
+            util::showError(tr("Error while syncing devices."));
+    });
 }
 
 void RazerGenie::toggleOffOnScreesaver(bool on)
 {
-    if(!libopenrazer::setTurnOffOnScreensaver(on))
-        util::showError(tr("Error while toggling 'turn off on screensaver'"));
+    libopenrazer::setTurnOffOnScreensaverAsync(on).then(this, [](bool success) {
+        if(!success)
+            util::showError(tr("Error while toggling 'turn off on screensaver'"));
+    });
 }
 
 void RazerGenie::colorButtonClicked()
@@ -859,7 +985,6 @@ void RazerGenie::colorButtonClicked()
     qDebug() << "color dialog";
 
     QPushButton *sender = qobject_cast<QPushButton*>(QObject::sender());
-    qDebug() << sender->objectName();
 
     QPalette pal(sender->palette());
 
@@ -873,101 +998,68 @@ void RazerGenie::colorButtonClicked()
     } else {
         qInfo() << "User cancelled the dialog.";
     }
-    // objectName is location(int)_colorbuttonNR(1-3)
-    // TODO: We shouldn't assume the world to be perfect!
-    applyEffect(static_cast<libopenrazer::Device::LightingLocation>(sender->objectName().split("_")[0].toInt()));
+    // Find the zone of the button
+    RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
+    for(int loc=0; loc<DeviceControls::ZoneCount; loc++) {
+        const ZoneControls &zone = item->controls().zones[loc];
+        if(zone.colorButtons[0] == sender || zone.colorButtons[1] == sender || zone.colorButtons[2] == sender) {
+            applyEffect(static_cast<libopenrazer::Device::LightingLocation>(loc));
+            return;
+        }
+    }
 }
 
-QPair<libopenrazer::Device*, QString> RazerGenie::commonCombo(int index)
+void RazerGenie::effectComboChanged(int index, libopenrazer::Device::LightingLocation location)
 {
-    QComboBox *sender = qobject_cast<QComboBox*>(QObject::sender());
-    libopenrazer::RazerCapability capability = sender->itemData(index).value<libopenrazer::RazerCapability>();
-    QString identifier = capability.getIdentifier();
-
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
-    libopenrazer::Device *dev = devices.value(item->getSerial());
+    const ZoneControls &zone = item->controls().zones[location];
+    const libopenrazer::Effect &effect = libopenrazer::effects[zone.comboBox->itemData(index).toInt()];
+
+    qDebug() << effect.identifier;
 
     // Show/hide the color buttons
-    if(capability.getNumColors() == 0) { // hide all
-        for(int i=1; i<=3; i++)
-            item->findChild<QPushButton*>(sender->objectName() + "_colorbutton" + QString::number(i))->hide();
-    } else {
-        for(int i=1; i<=3; i++) {
-            if(capability.getNumColors() < i)
-                item->findChild<QPushButton*>(sender->objectName() + "_colorbutton" + QString::number(i))->hide();
-            else
-                item->findChild<QPushButton*>(sender->objectName() + "_colorbutton" + QString::number(i))->show();
-        }
+    for(int i=1; i<=3; i++) {
+        zone.colorButtons[i-1]->setVisible(effect.numColors >= i);
     }
 
     // Show/hide the wave radiobuttons
-    if(capability.isWave() == 0) {
-        item->findChild<QRadioButton*>(sender->objectName() + "_radiobutton1")->hide();
-        item->findChild<QRadioButton*>(sender->objectName() + "_radiobutton2")->hide();
-    } else {
-        item->findChild<QRadioButton*>(sender->objectName() + "_radiobutton1")->show();
-        item->findChild<QRadioButton*>(sender->objectName() + "_radiobutton2")->show();
-    }
+    zone.waveLeft->setVisible(effect.wave);
+    zone.waveRight->setVisible(effect.wave);
 
-    return qMakePair(dev, identifier);
+    applyEffect(location);
 }
 
 void RazerGenie::standardCombo(int index)
 {
-    QPair<libopenrazer::Device*, QString> tuple = commonCombo(index);
-    libopenrazer::Device *dev = tuple.first;
-    QString identifier = tuple.second;
-
-    qDebug() << tuple;
-
-    applyEffectStandardLoc(identifier, dev);
+    effectComboChanged(index, libopenrazer::Device::Lighting);
 }
 
 void RazerGenie::scrollCombo(int index)
 {
-    QPair<libopenrazer::Device*, QString> tuple = commonCombo(index);
-    libopenrazer::Device *dev = tuple.first;
-    QString identifier = tuple.second;
-
-    qDebug() << tuple;
-
-    applyEffectScrollLoc(identifier, dev);
+    effectComboChanged(index, libopenrazer::Device::LightingScroll);
 }
 
 void RazerGenie::logoCombo(int index)
 {
-    QPair<libopenrazer::Device*, QString> tuple = commonCombo(index);
-    libopenrazer::Device *dev = tuple.first;
-    QString identifier = tuple.second;
-
-    qDebug() << tuple;
-
-    applyEffectLogoLoc(identifier, dev);
+    effectComboChanged(index, libopenrazer::Device::LightingLogo);
 }
 
 void RazerGenie::backlightCombo(int index)
 {
-    QPair<libopenrazer::Device*, QString> tuple = commonCombo(index);
-    libopenrazer::Device *dev = tuple.first;
-    QString identifier = tuple.second;
-
-    qDebug() << tuple;
-
-    applyEffectBacklightLoc(identifier, dev);
+    effectComboChanged(index, libopenrazer::Device::LightingBacklight);
 }
 
 QColor RazerGenie::getColorForButton(int num, libopenrazer::Device::LightingLocation location)
 {
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
-    QPalette pal = item->findChild<QPushButton*>(QString::number(location) + "_colorbutton" + QString::number(num))->palette();
-    return pal.color(QPalette::Button);
+    return item->controls().zones[location].colorButtons[num-1]->palette().color(QPalette::Button);
 }
 
 libopenrazer::WaveDirection RazerGenie::getWaveDirection(libopenrazer::Device::LightingLocation location)
 {
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
 
-    return item->findChild<QRadioButton*>(QString::number(location) + "_radiobutton1")->isChecked() ? libopenrazer::WAVE_LEFT : libopenrazer::WAVE_RIGHT;
+    return item->controls().zones[location].waveLeft->isChecked() ? libopenrazer::WAVE_LEFT : libopenrazer::WAVE_RIGHT;
 }
 
 void RazerGenie::brightnessChanged(int value)
@@ -976,7 +1068,7 @@ void RazerGenie::brightnessChanged(int value)
 
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
     libopenrazer::Device *dev = devices.value(item->getSerial());
-    dev->setBrightness(value);
+    dev->setBrightnessQueued(value);
 }
 
 void RazerGenie::scrollBrightnessChanged(int value)
@@ -985,7 +1077,7 @@ void RazerGenie::scrollBrightnessChanged(int value)
 
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
     libopenrazer::Device *dev = devices.value(item->getSerial());
-    dev->setScrollBrightness(value);
+    dev->setScrollBrightnessQueued(value);
 }
 
 void RazerGenie::logoBrightnessChanged(int value)
@@ -994,7 +1086,7 @@ void RazerGenie::logoBrightnessChanged(int value)
 
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
     libopenrazer::Device *dev = devices.value(item->getSerial());
-    dev->setLogoBrightness(value);
+    dev->setLogoBrightnessQueued(value);
 }
 
 void RazerGenie::backlightBrightnessChanged(int value)
@@ -1003,7 +1095,7 @@ void RazerGenie::backlightBrightnessChanged(int value)
 
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
     libopenrazer::Device *dev = devices.value(item->getSerial());
-    dev->setBacklightBrightness(value);
+    dev->setBacklightBrightnessQueued(value);
 }
 
 void RazerGenie::dpiChanged(int orig_value)
@@ -1012,42 +1104,35 @@ void RazerGenie::dpiChanged(int orig_value)
 
     QSlider *sender = qobject_cast<QSlider*>(QObject::sender());
 
+    // get device pointer and the sliders of the page
+    RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
+    libopenrazer::Device *dev = devices.value(item->getSerial());
+    const DeviceControls &controls = item->controls();
+    bool isX = sender == controls.dpiX;
+
     qDebug() << value;
-    qDebug() << sender->objectName();
 
     // if DPI should be synced
     if(syncDpi) {
-        if(sender->objectName() == "dpiX") {
+        if(isX) {
             // set the other slider
-            QSlider *slider = sender->parentWidget()->findChild<QSlider*>("dpiY");
-            slider->setValue(orig_value);
-
-            // get device pointer
-            RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
-            libopenrazer::Device *dev = devices.value(item->getSerial());
+            controls.dpiY->setValue(orig_value);
             // set DPI
-            dev->setDPI(value, value); // set for both X & Y
+            dev->setDPIQueued(value, value); // set for both X & Y
         } else {
             // just set the slider (as the rest was done already or will be done)
-            QSlider *slider = sender->parentWidget()->findChild<QSlider*>("dpiX");
-            slider->setValue(orig_value);
+            controls.dpiX->setValue(orig_value);
         }
     } /* if DPI should NOT be synced */ else {
-        // get device pointer
-        RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
-        libopenrazer::Device *dev = devices.value(item->getSerial());
-
         // set DPI (with value from other slider)
-        if(sender->objectName() == "dpiX") {
-            QSlider *slider = sender->parentWidget()->findChild<QSlider*>("dpiY");
-            dev->setDPI(value, slider->value()*100);
+        if(isX) {
+            dev->setDPIQueued(value, controls.dpiY->value()*100);
         } else {
-            QSlider *slider = sender->parentWidget()->findChild<QSlider*>("dpiX");
-            dev->setDPI(slider->value()*100, value);
+            dev->setDPIQueued(controls.dpiX->value()*100, value);
         }
     }
     // Update textbox with new value
-    QTextEdit *dpitextbox = sender->parentWidget()->findChild<QTextEdit*>(sender->objectName() + "Text");
+    QTextEdit *dpitextbox = isX ? controls.dpiXText : controls.dpiYText;
     dpitextbox->setText(QString::number(value));
 }
 
@@ -1062,155 +1147,23 @@ void RazerGenie::dpiComboChanged(int /* index */)
     dev->setDPI(sender->currentData().toInt(), -1);
 }
 
-void RazerGenie::applyEffectStandardLoc(QString identifier, libopenrazer::Device *device)
-{
-    libopenrazer::Device::LightingLocation zone = libopenrazer::Device::Lighting;
-
-    if(identifier == "lighting_breath_single") {
-        QColor c = getColorForButton(1, zone);
-        device->setBreathSingle(c);
-    } else if(identifier == "lighting_breath_dual") {
-        QColor c1 = getColorForButton(1, zone);
-        QColor c2 = getColorForButton(2, zone);
-        device->setBreathDual(c1, c2);
-    } else if(identifier == "lighting_breath_triple") {
-        QColor c1 = getColorForButton(1, zone);
-        QColor c2 = getColorForButton(2, zone);
-        QColor c3 = getColorForButton(3, zone);
-        device->setBreathTriple(c1, c2, c3);
-    } else if(identifier == "lighting_breath_random") {
-        device->setBreathRandom();
-    } else if(identifier == "lighting_wave") {
-        device->setWave(getWaveDirection(zone));
-    } else if(identifier == "lighting_reactive") {
-        QColor c = getColorForButton(1, zone);
-        device->setReactive(c, libopenrazer::REACTIVE_500MS); // TODO Configure speed?
-    } else if(identifier == "lighting_none") {
-        device->setNone();
-    } else if(identifier == "lighting_spectrum") {
-        device->setSpectrum();
-    } else if(identifier == "lighting_static") {
-        QColor c = getColorForButton(1, zone);
-        device->setStatic(c);
-    } else if(identifier == "lighting_ripple") {
-        QColor c = getColorForButton(1, zone);
-        device->setRipple(c, libopenrazer::RIPPLE_REFRESH_RATE); //TODO Configure refreshrate?
-    } else if(identifier == "lighting_ripple_random") {
-        device->setRippleRandomColor(libopenrazer::RIPPLE_REFRESH_RATE); //TODO Configure refreshrate?
-    } else if(identifier == "lighting_static_bw2013") {
-        device->setStatic_bw2013();
-    } else if(identifier == "lighting_pulsate") {
-        device->setPulsate();
-    } else {
-        qWarning() << identifier << " is not implemented yet!";
-    }
-}
-
-void RazerGenie::applyEffectLogoLoc(QString identifier, libopenrazer::Device *device)
-{
-    libopenrazer::Device::LightingLocation zone = libopenrazer::Device::LightingLogo;
-
-    if(identifier == "lighting_logo_blinking") {
-        QColor c = getColorForButton(1, zone);
-        device->setLogoBlinking(c);
-    } else if(identifier == "lighting_logo_pulsate") {
-        QColor c = getColorForButton(1, zone);
-        device->setLogoPulsate(c);
-    } else if(identifier == "lighting_logo_spectrum") {
-        device->setLogoSpectrum();
-    } else if(identifier == "lighting_logo_static") {
-        QColor c = getColorForButton(1, zone);
-        device->setLogoStatic(c);
-    } else if(identifier == "lighting_logo_none") {
-        device->setLogoNone();
-    } else if(identifier == "lighting_logo_reactive") {
-        QColor c = getColorForButton(1, zone);
-        device->setLogoReactive(c, libopenrazer::REACTIVE_500MS); // TODO Configure speed?
-    } else if(identifier == "lighting_logo_breath_single") {
-        QColor c = getColorForButton(1, zone);
-        device->setLogoBreathSingle(c);
-    } else if(identifier == "lighting_logo_breath_dual") {
-        QColor c1 = getColorForButton(1, zone);
-        QColor c2 = getColorForButton(2, zone);
-        device->setLogoBreathDual(c1, c2);
-    } else if(identifier == "lighting_logo_breath_random") {
-        device->setLogoBreathRandom();
-    } else {
-        qWarning() << identifier << " is not implemented yet!";
-    }
-}
-
-void RazerGenie::applyEffectScrollLoc(QString identifier, libopenrazer::Device *device)
-{
-    libopenrazer::Device::LightingLocation zone = libopenrazer::Device::LightingScroll;
-
-    if(identifier == "lighting_scroll_blinking") {
-        QColor c = getColorForButton(1, zone);
-        device->setScrollBlinking(c);
-    } else if(identifier == "lighting_scroll_pulsate") {
-        QColor c = getColorForButton(1, zone);
-        device->setScrollPulsate(c);
-    } else if(identifier == "lighting_scroll_spectrum") {
-        device->setScrollSpectrum();
-    } else if(identifier == "lighting_scroll_static") {
-        QColor c = getColorForButton(1, zone);
-        device->setScrollStatic(c);
-    } else if(identifier == "lighting_scroll_none") {
-        device->setScrollNone();
-    } else if(identifier == "lighting_scroll_reactive") {
-        QColor c = getColorForButton(1, zone);
-        device->setScrollReactive(c, libopenrazer::REACTIVE_500MS); // TODO Configure speed?
-    } else if(identifier == "lighting_scroll_breath_single") {
-        QColor c = getColorForButton(1, zone);
-        device->setScrollBreathSingle(c);
-    } else if(identifier == "lighting_scroll_breath_dual") {
-        QColor c1 = getColorForButton(1, zone);
-        QColor c2 = getColorForButton(2, zone);
-        device->setScrollBreathDual(c1, c2);
-    } else if(identifier == "lighting_scroll_breath_random") {
-        device->setScrollBreathRandom();
-    } else {
-        qWarning() << identifier << " is not implemented yet!";
-    }
-}
-
-void RazerGenie::applyEffectBacklightLoc(QString identifier, libopenrazer::Device *device)
-{
-    libopenrazer::Device::LightingLocation zone = libopenrazer::Device::LightingBacklight;
-
-    if(identifier == "lighting_backlight_spectrum") {
-        device->setBacklightSpectrum();
-    } else if(identifier == "lighting_backlight_static") {
-        QColor c = getColorForButton(1, zone);
-        device->setBacklightStatic(c);
-    } else {
-        qWarning() << identifier << " is not implemented yet!";
-    }
-}
-
-
 void RazerGenie::applyEffect(libopenrazer::Device::LightingLocation loc)
 {
     qDebug() << "applyEffect()";
     RazerDeviceWidget *item = dynamic_cast<RazerDeviceWidget*>(ui_main.stackedWidget->currentWidget());
-    QComboBox *combobox = item->findChild<QComboBox*>(QString::number(loc));
-
-    libopenrazer::RazerCapability capability = combobox->itemData(combobox->currentIndex()).value<libopenrazer::RazerCapability>();
-    QString identifier = capability.getIdentifier();
+    QComboBox *combobox = item->controls().zones[loc].comboBox;
+    const libopenrazer::Effect &effect = libopenrazer::effects[combobox->currentData().toInt()];
 
     libopenrazer::Device *dev = devices.value(item->getSerial());
 
-    if(loc == libopenrazer::Device::Lighting) {
-        applyEffectStandardLoc(identifier, dev);
-    } else if(loc == libopenrazer::Device::LightingLogo) {
-        applyEffectLogoLoc(identifier, dev);
-    } else if(loc == libopenrazer::Device::LightingScroll) {
-        applyEffectScrollLoc(identifier, dev);
-    } else if(loc == libopenrazer::Device::LightingBacklight) {
-        applyEffectBacklightLoc(identifier, dev);
-    } else {
-        util::showError("Unhandled lighting location in applyEffect()");
+    // Only read what the effect uses, the other buttons are hidden
+    libopenrazer::EffectParams params;
+    for(int i=1; i<=effect.numColors; i++) {
+        params.colors[i-1] = getColorForButton(i, loc);
     }
+    params.direction = effect.wave ? getWaveDirection(loc) : libopenrazer::WAVE_LEFT;
+
+    effect.apply(dev, params);
 }
 
 void RazerGenie::waveRadioButtonStandard(bool enabled)
@@ -1283,12 +1236,13 @@ void RazerGenie::profileLedCheckbox(bool checked)
     libopenrazer::Device *dev = devices.value(item->getSerial());
 
     QCheckBox *sender = qobject_cast<QCheckBox*>(QObject::sender());
+    const DeviceControls &controls = item->controls();
 
-    if(sender->objectName() == "1") {
+    if(sender == controls.profileLeds[0]) {
         dev->setRedLED(checked);
-    } else if(sender->objectName() == "2") {
+    } else if(sender == controls.profileLeds[1]) {
         dev->setGreenLED(checked);
-    } else if(sender->objectName() == "3") {
+    } else if(sender == controls.profileLeds[2]) {
         dev->setBlueLED(checked);
     }
 }
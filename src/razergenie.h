@@ -21,8 +21,13 @@
 
 #include "ui_razergenie.h"
 #include "razerimagedownloader.h"
+#include "razerdevicewidget.h"
+#include "devicelistmodel.h"
 #include "libopenrazer/libopenrazer.h"
 #include <QComboBox>
+#include <QSet>
+
+#include <functional>
 
 class RazerGenie : public QWidget
 {
@@ -92,31 +97,36 @@ private:
 
     QWidget *noDevicePlaceholder = NULL;
 
-    QList<QPair<int, int>> getConnectedDevices_lsusb();
-
-    void fillDeviceList();
+    void fillDeviceList(const QStringList &serialnrs);
     void refreshDeviceList();
     void clearDeviceList();
 
-    void addDeviceToGui(const QString &serial);
+    void addDeviceToGui(libopenrazer::Device *currentDevice);
+    void buildDevicePage(RazerDeviceWidget *widget);
+    void devicePageChanged(int index);
     bool removeDeviceFromGui(const QString &serial);
     QWidget *getNoDevicePlaceholder();
+    void showNoDevicePlaceholder();
+    static void showProperty(libopenrazer::DeviceProperties *properties, libopenrazer::DeviceProperties::Property property, QWidget *control, const std::function<void(const QVariant &)> &apply);
 
-    QPair<libopenrazer::Device*, QString> commonCombo(int index);
+    void effectComboChanged(int index, libopenrazer::Device::LightingLocation location);
 
     void getRazerDevices(void);
     QColor getColorForButton(int num, libopenrazer::Device::LightingLocation location);
     libopenrazer::WaveDirection getWaveDirection(libopenrazer::Device::LightingLocation location);
 
     void applyEffect(libopenrazer::Device::LightingLocation location);
-    void applyEffectStandardLoc(QString identifier, libopenrazer::Device *device);
-    void applyEffectLogoLoc(QString identifier, libopenrazer::Device *device);
-    void applyEffectScrollLoc(QString identifier, libopenrazer::Device *device);
-    void applyEffectBacklightLoc(QString identifier, libopenrazer::Device *device);
 
     bool syncDpi = true;
 
     QHash<QString, libopenrazer::Device*> devices;
+    // Devices being created on a worker thread, see fillDeviceList()
+    QSet<QString> creatingSerials;
+    DeviceListModel *deviceListModel = NULL;
+    // Device pages that are built, the least recently shown first
+    QList<RazerDeviceWidget*> builtPages;
+    static const int maxBuiltPages = 4;
+    libopenrazer::DeviceCache *deviceCache = NULL;
 };
 
 
@@ -16,76 +16,151 @@
  *
  */
 
-#include <iostream>
-
-#include <QString>
-#include <QtNetwork/QNetworkRequest>
-#include <QtNetwork/QNetworkAccessManager>
-#include <QDataStream>
-#include <QFile>
+#include <QDebug>
 #include <QDir>
-#include <QStandardPaths>
+#include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtNetwork/QNetworkRequest>
 
 #include "razerimagedownloader.h"
 
+/*
+ * Downloads the device images, shared by the whole application.
+ * All downloads go through one QNetworkAccessManager, a fetch for a URL that is already queued or running is merged into it
+ * and only maxRunning requests are in flight at the same time. Files are written to a temporary file first and renamed
+ * afterwards, so an aborted download never leaves a truncated image behind.
+ * Images that exist already are revalidated once per start with the ETag / Last-Modified of the previous download.
+ */
+RazerImageDownloader *RazerImageDownloader::instance()
+{
+    static RazerImageDownloader *downloader = new RazerImageDownloader();
+    return downloader;
+}
 
-RazerImageDownloader::RazerImageDownloader(QUrl url, QObject *parent) : QObject(parent)
+RazerImageDownloader::RazerImageDownloader(QObject *parent) : QObject(parent)
 {
     manager = new QNetworkAccessManager(this);
-    this->url = url;
+    connect(manager, &QNetworkAccessManager::finished, this, &RazerImageDownloader::finished);
+    downloadEnabled = settings.value("downloadImages").toBool();
+}
+
+RazerImageDownloader::~RazerImageDownloader()
+{
 }
 
-void RazerImageDownloader::startDownload()
+/**
+ * Fetches the image behind \a url into getFilePath().
+ * downloadFinished() is emitted once the file was written. If it exists already, it's only revalidated and
+ * downloadFinished() is emitted only if the server returned a newer image.
+ */
+void RazerImageDownloader::fetch(const QUrl &url)
 {
-    QString path = getDownloadPath();
-    // Create directory
-    QDir dir(path);
-    dir.mkpath(path);
-
-    _filepath = path + QFileInfo(url.path()).fileName();
-    _file = new QFile(_filepath);
-    if(_file->exists()) {
+    if(pending.contains(url) || done.contains(url)) {
         return;
     }
-    if(!settings.value("downloadImages").toBool()) {
-        emit downloadErrored(tr("Image download disabled"), tr("Image downloading is disabled. Visit the preferences to enable it."));
+    bool exists = QFile::exists(getFilePath(url));
+    if(!downloadEnabled) {
+        if(!exists) {
+            emit downloadErrored(url, tr("Image download disabled"), tr("Image downloading is disabled. Visit the preferences to enable it."));
+        }
         return;
     }
 
-    // TODO: What happens when two devices of the same model are connected?
-
-    QNetworkRequest request;
-    request.setUrl(url);
-    request.setRawHeader("User-Agent", "Mozilla Firefox");
+    pending.insert(url);
+    queue.enqueue(url);
+    startNext();
+}
 
-    connect(manager, &QNetworkAccessManager::finished, this, &RazerImageDownloader::finished);
+/**
+ * Sets whether images may be downloaded, which is stored as the \c downloadImages setting.
+ */
+void RazerImageDownloader::setDownloadEnabled(bool enabled)
+{
+    downloadEnabled = enabled;
+    settings.setValue("downloadImages", enabled);
+}
 
-    manager->get(request);
+bool RazerImageDownloader::isDownloadEnabled() const
+{
+    return downloadEnabled;
 }
 
-RazerImageDownloader::~RazerImageDownloader()
+void RazerImageDownloader::startNext()
 {
-    // TODO: Complete destructor (no idea how they work / what you have to do)
-    delete _file;
-    delete manager;
+    while(running < maxRunning && !queue.isEmpty()) {
+        QUrl url = queue.dequeue();
+
+        QNetworkRequest request(url);
+        request.setRawHeader("User-Agent", "Mozilla Firefox");
+        // Only send the validators if the file they belong to is still there
+        if(QFile::exists(getFilePath(url))) {
+            settings.beginGroup("imageValidators/" + QFileInfo(url.path()).fileName());
+            QByteArray etag = settings.value("etag").toByteArray();
+            QByteArray lastModified = settings.value("lastModified").toByteArray();
+            settings.endGroup();
+            if(!etag.isEmpty()) {
+                request.setRawHeader("If-None-Match", etag);
+            }
+            if(!lastModified.isEmpty()) {
+                request.setRawHeader("If-Modified-Since", lastModified);
+            }
+        }
+
+        running++;
+        manager->get(request);
+    }
 }
 
-void RazerImageDownloader::finished(QNetworkReply* reply)
+void RazerImageDownloader::finished(QNetworkReply *reply)
 {
+    reply->deleteLater();
+    QUrl url = reply->request().url();
+    running--;
+    pending.remove(url);
+    startNext();
+
+    QString filepath = getFilePath(url);
+    bool exists = QFile::exists(filepath);
     if(reply->error() != QNetworkReply::NoError) {
-        emit downloadErrored(tr("Network Error"), QVariant::fromValue(reply->error()).value<QString>());
+        // An existing image is still fine to show
+        if(!exists) {
+            emit downloadErrored(url, tr("Network Error"), reply->errorString());
+        } else {
+            qDebug() << "RazerGenie: Revalidating image failed:" << url << reply->errorString();
+        }
         return;
     }
+    done.insert(url);
 
-    _file->open(QFile::WriteOnly);
-    _file->write(reply->readAll());
-    _file->flush();
-    _file->close();
+    // Not modified, the file on disk is current
+    if(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        return;
+    }
 
-    reply->deleteLater();
+    QDir().mkpath(getDownloadPath());
+    QSaveFile file(filepath);
+    if(!file.open(QIODevice::WriteOnly) || file.write(reply->readAll()) == -1 || !file.commit()) {
+        if(!exists) {
+            emit downloadErrored(url, tr("Write Error"), file.errorString());
+        }
+        return;
+    }
+    saveValidators(url, reply);
 
-    emit downloadFinished(_filepath);
+    emit downloadFinished(url, filepath);
+}
+
+/**
+ * Remembers the ETag and Last-Modified headers of \a reply for revalidating the image behind \a url later.
+ */
+void RazerImageDownloader::saveValidators(const QUrl &url, QNetworkReply *reply)
+{
+    settings.beginGroup("imageValidators/" + QFileInfo(url.path()).fileName());
+    settings.setValue("etag", reply->rawHeader("ETag"));
+    settings.setValue("lastModified", reply->rawHeader("Last-Modified"));
+    settings.endGroup();
 }
 
 QString RazerImageDownloader::getDownloadPath()
@@ -93,3 +168,11 @@ QString RazerImageDownloader::getDownloadPath()
     // Should be ~/.local/share/razergenie/devicepictures/
     return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/razergenie/devicepictures/";
 }
+
+/**
+ * Returns the path the image behind \a url is stored at.
+ */
+QString RazerImageDownloader::getFilePath(const QUrl &url)
+{
+    return getDownloadPath() + QFileInfo(url.path()).fileName();
+}
@@ -19,30 +19,49 @@
 #ifndef RAZERIMAGEDOWNLOADER_H
 #define RAZERIMAGEDOWNLOADER_H
 
-#include <QFile>
+#include <QHash>
+#include <QQueue>
+#include <QSet>
 #include <QSettings>
-#include <QtNetwork/QNetworkRequest>
+#include <QUrl>
+#include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 
 class RazerImageDownloader : public QObject
 {
     Q_OBJECT
 public:
-    RazerImageDownloader(QUrl url, QObject *parent);
+    static RazerImageDownloader *instance();
     ~RazerImageDownloader();
-    void startDownload();
+
+    void fetch(const QUrl &url);
+    void setDownloadEnabled(bool enabled);
+    bool isDownloadEnabled() const;
+
     static QString getDownloadPath();
+    static QString getFilePath(const QUrl &url);
 signals:
-    void downloadFinished(QString &filename);
-    void downloadErrored(QString reason, QString longReason);
+    void downloadFinished(const QUrl &url, const QString &filename);
+    void downloadErrored(const QUrl &url, const QString &reason, const QString &longReason);
 private:
-    QFile *_file;
-    QString _filepath;
-    QUrl url;
+    RazerImageDownloader(QObject *parent = 0);
+    void startNext();
+    void saveValidators(const QUrl &url, QNetworkReply *reply);
+
+    // Requests in flight at most, further ones wait in the queue
+    static const int maxRunning = 3;
+
     QNetworkAccessManager *manager;
+    QQueue<QUrl> queue;
+    // Queued or running URLs, a second fetch for one of them is merged into the first
+    QSet<QUrl> pending;
+    // URLs that were downloaded or revalidated already since the start
+    QSet<QUrl> done;
+    int running = 0;
+    bool downloadEnabled;
     QSettings settings;
 private slots:
-    void finished(QNetworkReply* reply);
+    void finished(QNetworkReply *reply);
 };
 
 #endif // RAZERIMAGEDOWNLOADER_H
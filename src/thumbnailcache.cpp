@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2016-2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThreadPool>
+
+#include "thumbnailcache.h"
+
+/**
+ * Loads the thumbnail of one file on a worker thread and hands it back to the cache.
+ */
+class ThumbnailJob : public QRunnable
+{
+public:
+    ThumbnailJob(ThumbnailCache *cache, const QString &filename, int generation) : cache(cache), filename(filename), generation(generation) {}
+    void run() override
+    {
+        QImage image = ThumbnailCache::loadThumbnail(filename);
+        QMetaObject::invokeMethod(cache, "thumbnailLoaded", Qt::QueuedConnection, Q_ARG(QString, filename), Q_ARG(QImage, image), Q_ARG(int, generation));
+    }
+private:
+    ThumbnailCache *cache;
+    QString filename;
+    int generation;
+};
+
+/*
+ * Thumbnails of the device images, shared by the whole application.
+ * The originals are only decoded and scaled on a worker thread, the result is stored next to them (see getThumbnailPath())
+ * so later starts only read the small file. The last used thumbnails are kept in memory as well.
+ */
+ThumbnailCache *ThumbnailCache::instance()
+{
+    static ThumbnailCache *thumbnailCache = new ThumbnailCache();
+    return thumbnailCache;
+}
+
+ThumbnailCache::ThumbnailCache(QObject *parent) : QObject(parent), cache(maxCached)
+{
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+}
+
+/**
+ * Returns the thumbnail of \a filename if it's in memory, otherwise a null pixmap. Use request() to load it.
+ */
+QPixmap ThumbnailCache::thumbnail(const QString &filename) const
+{
+    QPixmap *pixmap = cache.object(filename);
+    return pixmap != NULL ? *pixmap : QPixmap();
+}
+
+/**
+ * Loads the thumbnail of \a filename on a worker thread and emits thumbnailReady() once it's there.
+ * If it's in memory already, thumbnailReady() is emitted right away.
+ */
+void ThumbnailCache::request(const QString &filename)
+{
+    QPixmap *pixmap = cache.object(filename);
+    if(pixmap != NULL) {
+        emit thumbnailReady(filename, *pixmap);
+        return;
+    }
+    if(pending.contains(filename)) {
+        return;
+    }
+    pending.insert(filename);
+    startJob(filename);
+}
+
+/**
+ * Loads the thumbnail of \a filename as it is now on a worker thread.
+ */
+void ThumbnailCache::startJob(const QString &filename)
+{
+    QThreadPool::globalInstance()->start(new ThumbnailJob(this, filename, generations.value(filename)));
+}
+
+/**
+ * Drops the thumbnail of \a filename from memory, e.g. after the original was replaced.
+ * The one on disk is recreated on the next request() as it's older than the original then.
+ * A thumbnail still being loaded might be the one of the old original, it's loaded again once it's there.
+ */
+void ThumbnailCache::invalidate(const QString &filename)
+{
+    cache.remove(filename);
+    generations[filename]++;
+}
+
+void ThumbnailCache::thumbnailLoaded(const QString &filename, const QImage &image, int generation)
+{
+    if(generation != generations.value(filename)) {
+        // Invalidated while loading, only one job per file runs at a time
+        startJob(filename);
+        return;
+    }
+    pending.remove(filename);
+    if(image.isNull()) {
+        qWarning() << "RazerGenie: Couldn't load image" << filename;
+        return;
+    }
+    // QPixmap can only be created on the GUI thread
+    QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image));
+    cache.insert(filename, pixmap);
+    emit thumbnailReady(filename, *pixmap);
+}
+
+/**
+ * Returns the path the thumbnail of \a filename is stored at, e.g. \c {razer-mamba.thumb.png} for \c {razer-mamba.png}.
+ */
+QString ThumbnailCache::getThumbnailPath(const QString &filename)
+{
+    QFileInfo info(filename);
+    return info.path() + "/" + info.completeBaseName() + ".thumb.png";
+}
+
+/**
+ * Returns the thumbnail of \a filename, reading it from disk if it's up to date and creating it from the original otherwise.
+ * Only uses QImage, so it can be called from any thread.
+ */
+QImage ThumbnailCache::loadThumbnail(const QString &filename)
+{
+    QString thumbnailPath = getThumbnailPath(filename);
+    QFileInfo original(filename);
+    QDateTime originalModified = original.lastModified();
+    QFileInfo stored(thumbnailPath);
+    if(stored.exists() && stored.lastModified() >= originalModified) {
+        QImage image(thumbnailPath);
+        if(!image.isNull()) {
+            return image;
+        }
+    }
+
+    QImage image(filename);
+    if(image.isNull()) {
+        return image;
+    }
+    image = image.scaled(thumbnailWidth, thumbnailHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    // Written to a temporary file first, so a concurrent reader never sees half a thumbnail
+    QSaveFile file(thumbnailPath);
+    if(!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit()) {
+        qWarning() << "RazerGenie: Couldn't store thumbnail" << thumbnailPath << file.errorString();
+    } else if(QFileInfo(filename).lastModified() != originalModified) {
+        // The original was replaced while it was being scaled, the thumbnail would look newer than it
+        QFile::remove(thumbnailPath);
+    }
+    return image;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016-2018  Luca Weiss <luca (at) z3ntu (dot) xyz>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+public:
+    static const int thumbnailWidth = 150;
+    static const int thumbnailHeight = 75;
+
+    static ThumbnailCache *instance();
+    ~ThumbnailCache();
+
+    QPixmap thumbnail(const QString &filename) const;
+    void request(const QString &filename);
+    void invalidate(const QString &filename);
+
+    static QString getThumbnailPath(const QString &filename);
+    static QImage loadThumbnail(const QString &filename);
+signals:
+    void thumbnailReady(const QString &filename, const QPixmap &thumbnail);
+private:
+    ThumbnailCache(QObject *parent = 0);
+
+    // Thumbnails kept in memory, the least recently used ones are dropped first
+    static const int maxCached = 32;
+
+    QCache<QString, QPixmap> cache;
+    // Files whose thumbnail is being loaded on a worker thread
+    QSet<QString> pending;
+    // Counts the invalidate() calls per file, a thumbnail loaded before the last one is outdated
+    QHash<QString, int> generations;
+
+    void startJob(const QString &filename);
+private slots:
+    void thumbnailLoaded(const QString &filename, const QImage &image, int generation);
+};
+
+#endif // THUMBNAILCACHE_H
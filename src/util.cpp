@@ -20,16 +20,23 @@
 
 #include <QMessageBox>
 
+/*
+ * Shows the box without waiting for it to be closed. These are called from reply callbacks,
+ * where the nested event loop of exec() would run further callbacks from within the current one.
+ */
+static void showMessage(QMessageBox::Icon icon, const QString &title, const QString &text)
+{
+    QMessageBox *messageBox = new QMessageBox(icon, title, text, QMessageBox::Ok);
+    messageBox->setAttribute(Qt::WA_DeleteOnClose);
+    messageBox->open();
+}
+
 void util::showError(QString error)
 {
-    QMessageBox messageBox;
-    messageBox.critical(0, QMessageBox::tr("Error!"), error);
-    messageBox.setFixedSize(500, 200);
+    showMessage(QMessageBox::Critical, QMessageBox::tr("Error!"), error);
 }
 
 void util::showInfo(QString info)
 {
-    QMessageBox messageBox;
-    messageBox.information(0, QMessageBox::tr("Information!"), info);
-    messageBox.setFixedSize(500, 200);
+    showMessage(QMessageBox::Information, QMessageBox::tr("Information!"), info);
 }